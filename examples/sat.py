@@ -29,14 +29,15 @@ def generate_cnf(numvars, numclauses, perclause=3, rgen=random):
     return [tuple(rgen.choice((-v,v)) for v in rgen.sample(
         range(1,numvars+1),3)) for c in range(numclauses)]
 
-def solve_sat(expression):
+def solve_sat(expression, nogil=False):
     """Attempts to satisfy a formula of conjunction of disjunctions.
 
     If there are n variables in the expression, this will return a
     list of length n, all elements booleans.  The truth of element i-1
     corresponds to the truth of variable i.
 
-    If no satisfying assignment could be found, None is returned."""
+    If no satisfying assignment could be found, None is returned.  If
+    nogil is true, the solvers release the GIL while they run."""
     # Trivial boundary case.
     if len(expression)==0: return []
     # Now many variables do we have?
@@ -93,7 +94,7 @@ def solve_sat(expression):
         lp.rows[-1].bounds = 1, None
 
     # Now we have the LP built.  Run the simplex algorithm.
-    retval = lp.simplex()
+    retval = lp.simplex(nogil=nogil)
 
     # If our iteration terminated prematurely, or if we do not have an
     # optimal solution, assume we have failed.
@@ -108,7 +109,7 @@ def solve_sat(expression):
         col.kind = int
 
     # Attempt to solve this MIP problem with the MIP solver.
-    retval = lp.integer()
+    retval = lp.integer(nogil=nogil)
 
     # Again, only returns non-None on failure.
     if retval != None: return None
@@ -2,17 +2,18 @@ import sat
 import sys
 import threading
 import gc
-# At present, GLPK itself, and consequently PyGLPK, are not thread
-# safe.  As a result, this "multithreaded" example at present does not
-# run the threads in parallel during solving.  I am, however,
-# retaining the example since I live in hope that
+# GLPK keeps a separate environment for each thread, so independent
+# problems may be solved in parallel as long as each problem is built
+# and solved within a single thread.  Passing nogil=True to the solvers
+# releases the GIL while GLPK runs, so the threads below really do
+# solve concurrently.
 
 vars, clauses = 50, 200
 num_threads = 8
 
 def solve_problem(tid, num):
     exp = sat.generate_cnf(vars, clauses)
-    assignment = sat.solve_sat(exp)
+    assignment = sat.solve_sat(exp, nogil=True)
     gc.collect()
     if assignment: assert sat.verify(exp, assignment)
     sys.stdout.write((('+' if assignment else '-')+'(%d,%2d)')%(tid,num))
@@ -5,7 +5,7 @@ import sys
 
 useparams = False
 
-sources = 'glpk 2to3 lp barcol bar obj util kkt tree environment'
+sources = 'glpk 2to3 lp barcol bar obj util kkt tree environment solve cancel search snapshot'
 source_roots = sources.split()
 if useparams:
     source_roots.append('params')
@@ -129,6 +129,7 @@ int Bar_SetMatrix(BarObject *self, PyObject *newvals) {
   int len, *ind = NULL;
   double *val = NULL;
   if (!Bar_Valid(self, 1)) return -1;
+  if (!LPX_CheckChange(self->py_bc->py_lp)) return -1;
   // Get the alternate length (e.g., col length if this is a row).
   len = (Bar_Row(self) ? glp_get_num_cols : glp_get_num_rows)(LP);
   // Now, attempt to convert the input item.
@@ -205,6 +206,7 @@ static PyObject* Bar_getname(BarObject *self, void *closure) {
 static int Bar_setname(BarObject *self, PyObject *value, void *closure) {
   char *name;
   if (!Bar_Valid(self, 1)) return -1;
+  if (!LPX_CheckChange(self->py_bc->py_lp)) return -1;
   if (value==NULL || value==Py_None) {
     (Bar_Row(self) ? glp_set_row_name : glp_set_col_name)
       (LP, Bar_Index(self)+1, NULL);
@@ -251,6 +253,7 @@ static int Bar_setbounds(BarObject *self, PyObject *value, void *closure) {
 
   void (*bounder)(glp_prob*,int,int,double,double) = NULL;
   if (!Bar_Valid(self, 1)) return -1;
+  if (!LPX_CheckChange(self->py_bc->py_lp)) return -1;
 
   i = Bar_Index(self)+1;
   bounder = Bar_Row(self) ? glp_set_row_bnds : glp_set_col_bnds;
@@ -334,6 +337,7 @@ static PyObject* Bar_getscale(BarObject *self, void *closure) {
 
 static int Bar_setscale(BarObject *self, PyObject *value, void *closure){
   if (!Bar_Valid(self, 1)) return -1;
+  if (!LPX_CheckChange(self->py_bc->py_lp)) return -1;
   if (value==NULL) {
     PyErr_SetString(PyExc_AttributeError, "cannot delete scale");
     return -1;
@@ -374,6 +378,7 @@ static PyObject* Bar_getstatus(BarObject *self, void *closure) {
 }
 static int Bar_setstatus(BarObject *self, PyObject *value, void *closure) {
   if (!Bar_Valid(self, 1)) return -1;
+  if (!LPX_CheckChange(self->py_bc->py_lp)) return -1;
   if (value==NULL) {
     PyErr_SetString(PyExc_AttributeError, "cannot delete status");
     return -1;
@@ -421,6 +426,7 @@ static PyObject* Bar_getkind(BarObject *self, void *closure) {
   return retval;
 }
 static int Bar_setkind(BarObject *self, PyObject *value, void *closure) {
+  if (!LPX_CheckChange(self->py_bc->py_lp)) return -1;
   if (value==(PyObject*)&PyFloat_Type) {
     // Float indicates a continuous variables.
     if (Bar_Row(self)) return 0;
@@ -452,31 +458,43 @@ static int Bar_setkind(BarObject *self, PyObject *value, void *closure) {
 /****************** THE DUAL/PRIMAL GETTING CODE **********/
 
 // Indexed by (last_solver*4 + isdual*2 + isrow)
-static double(*rowcol_primdual_funcptrs[])(glp_prob*,int) = {
+static valfunc_t rowcol_primdual_funcptrs[] = {
   glp_get_col_prim, glp_get_row_prim, glp_get_col_dual, glp_get_row_dual,
   glp_ipt_col_prim, glp_ipt_row_prim, glp_ipt_col_dual, glp_ipt_row_dual,
   glp_mip_col_val,  glp_mip_row_val,   NULL,            NULL };
 
-static PyObject* Bar_getvarval(BarObject *self, void *closure) {
-  if (!Bar_Valid(self, 1)) return NULL;
-  // Compute what we need to index to get the appropriate function pointer.
-  int isrow = Bar_Row(self) ? 1 : 0;
-  int isdual = closure==NULL ? 0 : 1;
-  int last = self->py_bc->py_lp->last_solver;
-  if (last < 0) last = 0; // If no solver called yet, assume simplex is OK.
+valfunc_t Bar_VarValFunc(LPXObject *py_lp, int solver, int isrow,
+			 int isdual) {
+  int last = solver;
+  if (last < 0) {
+    last = py_lp->last_solver;
+    if (last < 0) last = 0; // If no solver called yet, assume simplex is OK.
+  }
   if (last > 2) {
     PyErr_Format(PyExc_RuntimeError,
 		 "bad internal state for last solver identifier: %d", last);
     return NULL;
   }
+  if (solver == 2 && glp_get_num_int(py_lp->lp) == 0) {
+    PyErr_SetString(PyExc_TypeError,
+		    "MIP values require mixed integer problem");
+    return NULL;
+  }
   // Get and verify that function pointer.
-  double(*valfunc)(glp_prob*,int) =
-    rowcol_primdual_funcptrs[last*4 + isdual*2 + isrow];
+  valfunc_t valfunc = rowcol_primdual_funcptrs[last*4 + isdual*2 + isrow];
   if (valfunc==NULL) {
     PyErr_SetString(PyExc_RuntimeError,
 		    "dual values do not exist for MIP solver");
     return NULL;
   }
+  return valfunc;
+}
+
+static PyObject* Bar_getvarval(BarObject *self, void *closure) {
+  if (!Bar_Valid(self, 1)) return NULL;
+  valfunc_t valfunc = Bar_VarValFunc
+    (self->py_bc->py_lp, -1, Bar_Row(self) ? 1 : 0, closure==NULL ? 0 : 1);
+  if (valfunc==NULL) return NULL;
   // Get whatever sort of variable this is and return it.
   return PyFloat_FromDouble(valfunc(LP, Bar_Index(self)+1));
 }
@@ -55,6 +55,14 @@ PyObject *Bar_GetMatrix(BarObject *self);
    success.  Can be viewed as the complement to the get matrix
    function. */
 int Bar_SetMatrix(BarObject *b, PyObject *newvals);
+/* A GLPK function retrieving a row or column primal or dual value. */
+typedef double(*valfunc_t)(glp_prob*, int);
+/* Return the function retrieving primal (or, if isdual, dual) values of
+   columns (or, if isrow, rows) for the given solver, 0 for simplex, 1
+   for interior point, 2 for MIP, or -1 for whichever was run last.
+   Returns NULL with an exception set if there is no such function. */
+valfunc_t Bar_VarValFunc(LPXObject *py_lp, int solver, int isrow,
+			 int isdual);
 /* Init the type and related types it contains. 0 on success. */
 int Bar_InitType(PyObject *module);
 
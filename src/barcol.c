@@ -23,6 +23,7 @@ along with PyGLPK. If not, see <http://www.gnu.org/licenses/>.
 #include "bar.h"
 #include "util.h"
 #include "structmember.h"
+#include <math.h>
 
 #define LP (self->py_lp->lp)
 
@@ -142,6 +143,7 @@ BarObject *BarCol_Bar(BarColObject *self, int index) {
 
 static PyObject *BarCol_add(BarColObject *self, PyObject *args) {
   int n;
+  if (!LPX_CheckChange(self->py_lp)) return NULL;
   if (!PyArg_ParseTuple(args, "i", &n)) return NULL;
   if (n<1) {
     PyErr_SetString(PyExc_ValueError, "number of added entries must be >0");
@@ -309,6 +311,7 @@ static int PySet_Size(PyObject*s) { return PyDict_Size(s); }
 
 static int BarCol_ass_subscript(BarColObject *self, PyObject *item,
 				PyObject *value) {
+  if (!LPX_CheckChange(self->py_lp)) return -1;
   if (value == NULL) {
     // We're deleting. Woo hoo.
     int size = BarCol_Size(self);
@@ -418,6 +421,235 @@ static PyObject* BarCol_Str(BarColObject *self) {
      LPXType.tp_name, self->py_lp);
 }
 
+/****************** BULK ACCESSORS ***************/
+
+/* Map a solver name argument to the solver identifier used by
+   Bar_VarValFunc, or return -2 with an exception set. */
+static int barcol_solver(PyObject *solver) {
+  const char *name;
+  if (solver == NULL || solver == Py_None) return -1;
+  name = PyString_AsString(solver);
+  if (name == NULL) return -2;
+  if (!strcmp(name, "simplex")) return 0;
+  if (!strcmp(name, "interior")) return 1;
+  if (!strcmp(name, "integer")) return 2;
+  PyErr_Format(PyExc_ValueError, "solver '%s' unrecognized", name);
+  return -2;
+}
+
+static PyObject *BarCol_varvals(BarColObject *self, PyObject *args,
+				PyObject *kwds, int isdual) {
+  static char *kwlist[] = {"solver", NULL};
+  PyObject *solver = NULL, *retval;
+  valfunc_t valfunc;
+  double *data;
+  int i, n, which;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", kwlist, &solver))
+    return NULL;
+  if ((which = barcol_solver(solver)) < -1) return NULL;
+  valfunc = Bar_VarValFunc(self->py_lp, which, BarCol_Rows(self), isdual);
+  if (valfunc == NULL) return NULL;
+  n = BarCol_Size(self);
+  retval = util_new_buffer("d", n, (void**)&data);
+  if (retval == NULL) return NULL;
+  for (i=0; i<n; ++i) data[i] = valfunc(LP, i+1);
+  return retval;
+}
+
+static PyObject *BarCol_primal_array(BarColObject *self, PyObject *args,
+				     PyObject *kwds) {
+  return BarCol_varvals(self, args, kwds, 0);
+}
+
+static PyObject *BarCol_dual_array(BarColObject *self, PyObject *args,
+				   PyObject *kwds) {
+  return BarCol_varvals(self, args, kwds, 1);
+}
+
+/* Acquire a buffer argument holding one entry per row or column.
+   Returns 0 on failure with an exception set, 1 on success. */
+static int barcol_buffer(BarColObject *self, PyObject *ob, const char *name,
+			 Py_buffer *view) {
+  if (!util_buffer_get(ob, name, view)) return 0;
+  if (util_buffer_len(view) != BarCol_Size(self)) {
+    PyErr_Format(PyExc_ValueError, "%s must have length %d, not %zd",
+		 name, BarCol_Size(self), util_buffer_len(view));
+    PyBuffer_Release(view);
+    return 0;
+  }
+  return 1;
+}
+
+static PyObject *BarCol_get_bounds(BarColObject *self) {
+  int i, n = BarCol_Size(self), isrow = BarCol_Rows(self);
+  double *lb, *ub;
+  PyObject *lbob, *ubob, *retval = NULL;
+  lbob = util_new_buffer("d", n, (void**)&lb);
+  ubob = util_new_buffer("d", n, (void**)&ub);
+  if (lbob == NULL || ubob == NULL) goto done;
+  for (i=0; i<n; ++i) {
+    switch ((isrow ? glp_get_row_type : glp_get_col_type)(LP, i+1)) {
+    case GLP_FR: lb[i] = -Py_HUGE_VAL; ub[i] = Py_HUGE_VAL; break;
+    case GLP_LO:
+      lb[i] = (isrow ? glp_get_row_lb : glp_get_col_lb)(LP, i+1);
+      ub[i] = Py_HUGE_VAL;
+      break;
+    case GLP_UP:
+      lb[i] = -Py_HUGE_VAL;
+      ub[i] = (isrow ? glp_get_row_ub : glp_get_col_ub)(LP, i+1);
+      break;
+    default:
+      lb[i] = (isrow ? glp_get_row_lb : glp_get_col_lb)(LP, i+1);
+      ub[i] = (isrow ? glp_get_row_ub : glp_get_col_ub)(LP, i+1);
+    }
+  }
+  retval = PyTuple_Pack(2, lbob, ubob);
+ done:
+  Py_XDECREF(lbob);
+  Py_XDECREF(ubob);
+  return retval;
+}
+
+static PyObject *BarCol_set_bounds(BarColObject *self, PyObject *args) {
+  PyObject *lbob, *ubob, *retval = NULL;
+  Py_buffer lbv, ubv;
+  double *lb, *ub, *lbcopy = NULL, *ubcopy = NULL;
+  int i, n = BarCol_Size(self);
+  void (*bounder)(glp_prob*,int,int,double,double) =
+    BarCol_Rows(self) ? glp_set_row_bnds : glp_set_col_bnds;
+
+  if (!LPX_CheckChange(self->py_lp)) return NULL;
+  if (!PyArg_ParseTuple(args, "OO", &lbob, &ubob)) return NULL;
+  if (!barcol_buffer(self, lbob, "lower bounds", &lbv)) return NULL;
+  if (!barcol_buffer(self, ubob, "upper bounds", &ubv)) {
+    PyBuffer_Release(&lbv);
+    return NULL;
+  }
+  if ((lb = util_buffer_doubles(&lbv, "lower bounds", &lbcopy)) == NULL ||
+      (ub = util_buffer_doubles(&ubv, "upper bounds", &ubcopy)) == NULL)
+    goto done;
+  // Check everything before changing anything.
+  for (i=0; i<n; ++i) {
+    if (isfinite(lb[i]) && isfinite(ub[i]) && lb[i] > ub[i]) {
+      PyErr_Format(PyExc_ValueError,
+		   "lower bound cannot exceed upper bound at index %d", i);
+      goto done;
+    }
+  }
+  // Non-finite values mean there is no bound on that side.
+  for (i=0; i<n; ++i) {
+    int haslb = isfinite(lb[i]), hasub = isfinite(ub[i]);
+    if (haslb && hasub)
+      bounder(LP, i+1, lb[i]==ub[i] ? GLP_FX : GLP_DB, lb[i], ub[i]);
+    else if (haslb) bounder(LP, i+1, GLP_LO, lb[i], 0.0);
+    else if (hasub) bounder(LP, i+1, GLP_UP, 0.0, ub[i]);
+    else bounder(LP, i+1, GLP_FR, 0.0, 0.0);
+  }
+  retval = Py_None;
+  Py_INCREF(retval);
+ done:
+  free(lbcopy);
+  free(ubcopy);
+  PyBuffer_Release(&lbv);
+  PyBuffer_Release(&ubv);
+  return retval;
+}
+
+static PyObject *BarCol_set_kinds(BarColObject *self, PyObject *codes) {
+  Py_buffer view;
+  PyObject *retval = NULL;
+  int i, n = BarCol_Size(self), *kinds;
+  if (!LPX_CheckChange(self->py_lp)) return NULL;
+  if (!barcol_buffer(self, codes, "kinds", &view)) return NULL;
+  kinds = util_buffer_ints(&view, "kinds", 0);
+  PyBuffer_Release(&view);
+  if (kinds == NULL) return NULL;
+  for (i=0; i<n; ++i) {
+    if (kinds[i]!=GLP_CV && kinds[i]!=GLP_IV && kinds[i]!=GLP_BV) {
+      PyErr_Format(PyExc_ValueError, "kind code %d at index %d unrecognized",
+		   kinds[i], i);
+      goto done;
+    }
+    if (BarCol_Rows(self) && kinds[i]!=GLP_CV) {
+      PyErr_SetString(PyExc_ValueError,
+		      "row variables cannot be integer or binary");
+      goto done;
+    }
+  }
+  // Rows are always continuous, so there is nothing to set.
+  if (!BarCol_Rows(self))
+    for (i=0; i<n; ++i) glp_set_col_kind(LP, i+1, kinds[i]);
+  retval = Py_None;
+  Py_INCREF(retval);
+ done:
+  free(kinds);
+  return retval;
+}
+
+static PyObject *BarCol_set_scale(BarColObject *self, PyObject *factors) {
+  Py_buffer view;
+  PyObject *retval = NULL;
+  double *scale, *copy = NULL;
+  int i, n = BarCol_Size(self);
+  if (!LPX_CheckChange(self->py_lp)) return NULL;
+  if (!barcol_buffer(self, factors, "scale factors", &view)) return NULL;
+  if ((scale = util_buffer_doubles(&view, "scale factors", &copy)) == NULL)
+    goto done;
+  for (i=0; i<n; ++i) {
+    if (!(scale[i] > 0.0)) {
+      PyErr_SetString(PyExc_ValueError, "scale factors must be positive");
+      goto done;
+    }
+  }
+  for (i=0; i<n; ++i)
+    (BarCol_Rows(self) ? glp_set_rii : glp_set_sjj)(LP, i+1, scale[i]);
+  retval = Py_None;
+  Py_INCREF(retval);
+ done:
+  free(copy);
+  PyBuffer_Release(&view);
+  return retval;
+}
+
+static PyObject *BarCol_set_names(BarColObject *self, PyObject *seq) {
+  PyObject *fast, *item, *retval = NULL;
+  const char **names = NULL;
+  int i, n = BarCol_Size(self);
+  void (*namer)(glp_prob*,int,const char*) =
+    BarCol_Rows(self) ? glp_set_row_name : glp_set_col_name;
+
+  if (!LPX_CheckChange(self->py_lp)) return NULL;
+  fast = PySequence_Fast(seq, "names must be a sequence");
+  if (fast == NULL) return NULL;
+  if (PySequence_Fast_GET_SIZE(fast) != n) {
+    PyErr_Format(PyExc_ValueError, "names must have length %d, not %zd",
+		 n, PySequence_Fast_GET_SIZE(fast));
+    goto done;
+  }
+  names = (const char**)calloc(n ? n : 1, sizeof(const char*));
+  if (names == NULL) {
+    PyErr_NoMemory();
+    goto done;
+  }
+  // The strings are borrowed from the items, which fast keeps alive.
+  for (i=0; i<n; ++i) {
+    item = PySequence_Fast_GET_ITEM(fast, i);
+    if (item == Py_None) continue;
+    if ((names[i] = PyString_AsString(item)) == NULL) goto done;
+    if (PyString_Size(item) > 255) {
+      PyErr_SetString(PyExc_ValueError, "name may be at most 255 chars");
+      goto done;
+    }
+  }
+  for (i=0; i<n; ++i) namer(LP, i+1, names[i]);
+  retval = Py_None;
+  Py_INCREF(retval);
+ done:
+  free(names);
+  Py_DECREF(fast);
+  return retval;
+}
+
 /****************** GET-SET-ERS ***************/
 
 
@@ -463,6 +695,65 @@ PyDoc_STRVAR(add_doc,
 "index of the first added entry."
 );
 
+PyDoc_STRVAR(primal_array_doc,
+"primal_array([solver])\n"
+"\n"
+"Return the primal values of all rows or columns as a memoryview of\n"
+"doubles ('d' format), in index order. By default the values are those\n"
+"of the last solver run, as with the primal attribute of each bar. The\n"
+"solver may be given as 'simplex', 'interior' or 'integer' to select the\n"
+"values of that solver's solution instead, as with the primal_s, primal_i\n"
+"and value_m attributes."
+);
+
+PyDoc_STRVAR(dual_array_doc,
+"dual_array([solver])\n"
+"\n"
+"Return the dual values of all rows or columns as a memoryview of doubles\n"
+"('d' format), in index order. The solver argument is as for\n"
+"primal_array(), except that the MIP solver has no dual values."
+);
+
+PyDoc_STRVAR(get_bounds_doc,
+"get_bounds() -> (lower, upper)\n"
+"\n"
+"Return the lower and upper bounds of all rows or columns as two\n"
+"memoryviews of doubles ('d' format), in index order. A missing bound is\n"
+"reported as -inf or inf respectively."
+);
+
+PyDoc_STRVAR(set_bounds_doc,
+"set_bounds(lower, upper)\n"
+"\n"
+"Set the bounds of all rows or columns at once. The arguments are buffer\n"
+"protocol objects, e.g., array.array or NumPy arrays, holding one number\n"
+"per row or column. Infinite or NaN values mean there is no bound on that\n"
+"side, and equal bounds fix the variable, as with the bounds attribute of\n"
+"each bar. Nothing is changed if any lower bound exceeds its upper bound."
+);
+
+PyDoc_STRVAR(set_kinds_doc,
+"set_kinds(codes)\n"
+"\n"
+"Set the kind of all columns at once from a buffer of integer codes, one\n"
+"of LPX.CV (continuous), LPX.IV (integer) or LPX.BV (binary) per column.\n"
+"Rows are always continuous, so for rows every code must be LPX.CV."
+);
+
+PyDoc_STRVAR(set_scale_doc,
+"set_scale(factors)\n"
+"\n"
+"Set the scale factors of all rows or columns at once from a buffer of\n"
+"positive numbers."
+);
+
+PyDoc_STRVAR(set_names_doc,
+"set_names(names)\n"
+"\n"
+"Set the names of all rows or columns at once from a sequence of strings\n"
+"(or None to clear a name), as with the name attribute of each bar."
+);
+
 PyDoc_STRVAR(barcol_doc,
 "Bar collection objects\n"
 "\n"
@@ -490,6 +781,17 @@ PyDoc_STRVAR(barcol_doc,
 
 static PyMethodDef BarCol_methods[] = {
   {"add", (PyCFunction)BarCol_add, METH_VARARGS, add_doc},
+  {"primal_array", (PyCFunction)BarCol_primal_array,
+   METH_VARARGS|METH_KEYWORDS, primal_array_doc},
+  {"dual_array", (PyCFunction)BarCol_dual_array,
+   METH_VARARGS|METH_KEYWORDS, dual_array_doc},
+  {"get_bounds", (PyCFunction)BarCol_get_bounds, METH_NOARGS,
+   get_bounds_doc},
+  {"set_bounds", (PyCFunction)BarCol_set_bounds, METH_VARARGS,
+   set_bounds_doc},
+  {"set_kinds", (PyCFunction)BarCol_set_kinds, METH_O, set_kinds_doc},
+  {"set_scale", (PyCFunction)BarCol_set_scale, METH_O, set_scale_doc},
+  {"set_names", (PyCFunction)BarCol_set_names, METH_O, set_names_doc},
   {NULL}
 };
 
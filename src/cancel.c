@@ -0,0 +1,159 @@
+/**************************************************************************
+Copyright (C) 2007, 2008 Thomas Finley, tfinley@gmail.com
+
+This file is part of PyGLPK.
+
+PyGLPK is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+PyGLPK is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with PyGLPK.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#include "2to3.h"
+
+#include "cancel.h"
+#include "lp.h"
+#include "util.h"
+
+int Cancel_Check(PyObject *token)
+{
+	CancelTokenObject *t = (CancelTokenObject*)token;
+	if (t == NULL)
+		return 0;
+	if (!t->cancelled && t->deadline > 0 && glp_time() >= t->deadline)
+		t->cancelled = 1;
+	return t->cancelled;
+}
+
+int Cancel_Converter(PyObject *obj, void *addr)
+{
+	if (obj == Py_None) {
+		*(PyObject**)addr = NULL;
+	} else if (CancelToken_Check(obj)) {
+		*(PyObject**)addr = obj;
+	} else {
+		PyErr_Format(PyExc_TypeError, "cancel must be a CancelToken or "
+			     "None, not %.200s", Py_TYPE(obj)->tp_name);
+		return 0;
+	}
+	return 1;
+}
+
+PyObject* Cancel_Message(int retval, int cancelled)
+{
+	if (cancelled)
+		return PyString_FromString("cancelled");
+	return glpsolver_retval_to_message(retval);
+}
+
+/****************** OBJECT DEFINITION *********/
+
+static void CancelToken_dealloc(CancelTokenObject *self)
+{
+	if (self->weakreflist != NULL)
+		PyObject_ClearWeakRefs((PyObject*)self);
+	Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int CancelToken_init(CancelTokenObject *self, PyObject *args,
+			    PyObject *kwds)
+{
+	static char *kwlist[] = {"timeout", NULL};
+	PyObject *timeout = Py_None;
+	double seconds;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O:CancelToken", kwlist,
+					 &timeout))
+		return -1;
+	self->cancelled = 0;
+	self->deadline = 0;
+	if (timeout != Py_None) {
+		if ((seconds = PyFloat_AsDouble(timeout)) == -1.0 &&
+		    PyErr_Occurred())
+			return -1;
+		if (!(seconds >= 0.0)) {
+			PyErr_SetString(PyExc_ValueError,
+					"timeout must be non-negative");
+			return -1;
+		}
+		// glp_time counts milliseconds, and is never 0 itself.
+		self->deadline = glp_time() + 1000.0 * seconds;
+	}
+	return 0;
+}
+
+static PyObject* CancelToken_cancel(CancelTokenObject *self)
+{
+	self->cancelled = 1;
+	Py_RETURN_NONE;
+}
+
+static PyObject* CancelToken_getcancelled(CancelTokenObject *self,
+					  void *closure)
+{
+	return PyBool_FromLong(Cancel_Check((PyObject*)self));
+}
+
+int Cancel_InitType(PyObject *module)
+{
+	return util_add_type(module, &CancelTokenType);
+}
+
+PyDoc_STRVAR(cancel_doc,
+"cancel()\n"
+"\n"
+"Cancel the solves this token was given to. This may be called from any\n"
+"thread, e.g., while the solver runs upon another without the GIL.");
+
+static PyMethodDef CancelToken_methods[] = {
+	{"cancel", (PyCFunction)CancelToken_cancel, METH_NOARGS, cancel_doc},
+	{NULL}
+};
+
+PyDoc_STRVAR(cancelled_doc,
+"Whether cancel() has been called, or the timeout has passed."
+);
+
+static PyGetSetDef CancelToken_getset[] = {
+	{"cancelled", (getter)CancelToken_getcancelled, (setter)NULL,
+		cancelled_doc, NULL},
+	{NULL}
+};
+
+PyDoc_STRVAR(cancel_token_doc,
+"CancelToken(timeout=None)\n"
+"\n"
+"A token that stops the solves it is given to, through the cancel keyword\n"
+"argument of the solver methods, once cancel() is called upon it from any\n"
+"thread, or once timeout seconds have passed since it was made. A solver\n"
+"method stopped this way returns 'cancelled'.\n"
+"\n"
+"The solver stops at its next safe point. The integer solver checks the\n"
+"token whenever it would call a callback. The simplex and exact solvers\n"
+"then run in slices of iterations, resuming from the basis each left,\n"
+"and check it between slices; they do not use the presolver then. The\n"
+"interior point solver cannot be interrupted, and only checks it before\n"
+"starting. A signal handler runs once the main thread runs Python code,\n"
+"so to cancel upon a signal, solve upon another thread.");
+
+PyTypeObject CancelTokenType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name           = "glpk.CancelToken",
+    .tp_basicsize      = sizeof(CancelTokenObject),
+    .tp_dealloc        = (destructor)CancelToken_dealloc,
+    .tp_flags          = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .tp_doc            = cancel_token_doc,
+    .tp_weaklistoffset = offsetof(CancelTokenObject, weakreflist),
+    .tp_methods        = CancelToken_methods,
+    .tp_getset         = CancelToken_getset,
+    .tp_init           = (initproc)CancelToken_init,
+    .tp_new            = PyType_GenericNew,
+};
@@ -0,0 +1,48 @@
+/**************************************************************************
+Copyright (C) 2007, 2008 Thomas Finley, tfinley@gmail.com
+
+This file is part of PyGLPK.
+
+PyGLPK is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+PyGLPK is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with PyGLPK.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#ifndef _CANCEL_H
+#define _CANCEL_H
+
+#include <Python.h>
+#include <glpk.h>
+
+#define CancelToken_Check(op) PyObject_TypeCheck(op, &CancelTokenType)
+
+typedef struct {
+	PyObject_HEAD
+	volatile int cancelled; // Set by cancel(), from any thread.
+	double deadline; // From glp_time, or 0 if there is none.
+	PyObject *weakreflist; // Weak reference list.
+} CancelTokenObject;
+
+extern PyTypeObject CancelTokenType;
+
+/* Returns whether the token, which may be NULL, has been cancelled or is
+   past its deadline. This does not need the GIL. */
+int Cancel_Check(PyObject *token);
+/* A converter for the "O&" argument format, accepting a CancelToken,
+   stored as a borrowed reference, or None, stored as NULL. */
+int Cancel_Converter(PyObject *obj, void *addr);
+/* As glpsolver_retval_to_message, but "cancelled" if cancelled is set. */
+PyObject* Cancel_Message(int retval, int cancelled);
+/* Init the type. 0 on success. */
+int Cancel_InitType(PyObject *module);
+
+#endif // _CANCEL_H
@@ -21,6 +21,7 @@ along with PyGLPK. If not, see <http://www.gnu.org/licenses/>.
 
 #include <glpk.h>
 #include <limits.h>
+#include <string.h>
 #include "environment.h"
 #include "structmember.h"
 #include "util.h"
@@ -49,16 +50,23 @@ static void Environment_dealloc(EnvironmentObject *self)
 	Py_TYPE(self)->tp_free((PyObject*)self);
 }
 
+// The instance exposed by the module, whose settings worker threads adopt.
+static EnvironmentObject *environment_instance = NULL;
+
 EnvironmentObject* Environment_New(void)
 {
 	EnvironmentObject *env = (EnvironmentObject*)
 		PyObject_GC_New(EnvironmentObject, &EnvironmentType);
 	if (env == NULL)
 		return env;
+	if (environment_instance == NULL)
+		environment_instance = env;
 	// Initialize data members.
 	env->mem_limit = -1;
 	env->term_on = 1;
 	env->term_hook = NULL;
+	env->term_batch = 0;
+	env->term_interval = 1.0;
 	env->version = Py_BuildValue("ii", GLP_MAJOR_VERSION, GLP_MINOR_VERSION);
 	env->weakreflist = NULL;
 	// Now return the structure.
@@ -146,15 +154,196 @@ static int Environment_setmemlimit(EnvironmentObject *self, PyObject *value,
 
 /**************** TERMINAL BEHAVIOR ***********/
 
-static int environment_term_hook(EnvironmentObject *env, const char *s)
+/*
+ * When term_batch is set, GLPK output for the hook is held without needing
+ * the GIL, and passed on as whole lines once term_batch of them are held,
+ * or once the oldest has been held term_interval seconds. Each thread
+ * holds the line it is writing until it ends it, and only then appends it
+ * to this ring buffer, under its mutex, so that the lines of solvers on
+ * several threads never interleave. The lock order is the GIL before the
+ * mutex.
+ */
+#define TERM_BUFFER_SIZE 65536
+
+static struct {
+	PyThread_type_lock mutex;
+	char *data; // Allocated upon first use.
+	size_t head, len; // Where the held output starts, and its length.
+	size_t whole; // The length of the whole lines it starts with.
+	int lines; // The number of those whole lines.
+	double since; // When the first of them arrived, per glp_time.
+} term_buffer;
+
+/* The line held for the thread that set the hook. */
+static EnvironmentThread term_main;
+
+/* Copy output to the end of the buffer, which must have room. */
+static void environment_term_put(const char *s, size_t n)
+{
+	size_t tail, first;
+	tail = (term_buffer.head + term_buffer.len) % TERM_BUFFER_SIZE;
+	first = TERM_BUFFER_SIZE - tail;
+	first = first < n ? first : n;
+	memcpy(term_buffer.data + tail, s, first);
+	memcpy(term_buffer.data, s + first, n - first);
+	term_buffer.len += n;
+}
+
+/* Pass the held whole lines, or all the output if all is set, with the
+   line held for the thread that set the hook, to the hook. Must be called
+   with the GIL, and keeps any exception already set. */
+static void environment_term_deliver(EnvironmentObject *env, int all)
+{
+	PyObject *bytes = NULL, *text, *retval, *type, *value, *tb;
+	size_t n, first;
+
+	if (term_buffer.mutex == NULL)
+		return;
+	PyErr_Fetch(&type, &value, &tb);
+	PyThread_acquire_lock(term_buffer.mutex, WAIT_LOCK);
+	if (all && term_main.len > 0 &&
+	    term_main.len <= TERM_BUFFER_SIZE - term_buffer.len) {
+		environment_term_put(term_main.line, term_main.len);
+		term_main.len = 0;
+	}
+	n = all ? term_buffer.len : term_buffer.whole;
+	if (n > 0 && (bytes = PyBytes_FromStringAndSize(NULL, n)) != NULL) {
+		first = TERM_BUFFER_SIZE - term_buffer.head;
+		first = first < n ? first : n;
+		memcpy(PyBytes_AS_STRING(bytes),
+		       term_buffer.data + term_buffer.head, first);
+		memcpy(PyBytes_AS_STRING(bytes) + first, term_buffer.data,
+		       n - first);
+	}
+	// Output that cannot be passed on is dropped, as it cannot be held.
+	term_buffer.head = (term_buffer.head + n) % TERM_BUFFER_SIZE;
+	term_buffer.len -= n;
+	term_buffer.whole = 0;
+	term_buffer.lines = 0;
+	PyThread_release_lock(term_buffer.mutex);
+	if (bytes != NULL) {
+		text = PyUnicode_DecodeUTF8(PyBytes_AS_STRING(bytes), n,
+					    "replace");
+		Py_DECREF(bytes);
+		if (text != NULL && env->term_hook != NULL) {
+			retval = PyObject_CallFunctionObjArgs(env->term_hook,
+							      text, NULL);
+			Py_XDECREF(retval);
+		}
+		Py_XDECREF(text);
+	}
+	// The hook's errors go ignored, but not those of its caller.
+	PyErr_Clear();
+	PyErr_Restore(type, value, tb);
+}
+
+/* Append the thread's held line and then the output to the buffer, and
+   hold whatever of the output follows its last whole line in its place.
+   Returns whether it is time to deliver, or -1 if it does not fit. */
+static int environment_term_append(EnvironmentThread *t, const char *s,
+				   size_t n, size_t end)
+{
+	EnvironmentObject *env = t->env;
+	const char *nl;
+	int deliver, count = 0;
+
+	PyThread_acquire_lock(term_buffer.mutex, WAIT_LOCK);
+	if (t->len + end > TERM_BUFFER_SIZE - term_buffer.len) {
+		PyThread_release_lock(term_buffer.mutex);
+		return -1;
+	}
+	for (nl = s; (nl = memchr(nl, '\n', s + end - nl)) != NULL; ++nl) {
+		term_buffer.whole = term_buffer.len + t->len + (nl - s) + 1;
+		++count;
+	}
+	environment_term_put(t->line, t->len);
+	environment_term_put(s, end);
+	t->len = n - end;
+	memcpy(t->line, s + end, t->len);
+	if (count && term_buffer.lines == 0)
+		term_buffer.since = glp_time();
+	term_buffer.lines += count;
+	deliver = term_buffer.lines >= env->term_batch || (term_buffer.lines &&
+		glp_difftime(glp_time(), term_buffer.since) >= env->term_interval);
+	PyThread_release_lock(term_buffer.mutex);
+	return deliver;
+}
+
+/* Call the hook with the output directly, keeping any exception set. */
+static void environment_term_call(EnvironmentObject *env, const char *s)
+{
+	PyObject *retval, *type, *value, *tb;
+	if (env->term_hook == NULL)
+		return;
+	PyErr_Fetch(&type, &value, &tb);
+	retval = PyObject_CallFunction(env->term_hook, "s", s);
+	Py_XDECREF(retval);
+	PyErr_Clear();
+	PyErr_Restore(type, value, tb);
+}
+
+static int environment_term_hook(EnvironmentThread *t, const char *s)
 {
-	// When this is called, env->term_hook should *never* be NULL.
-	PyObject_CallFunction(env->term_hook, "s", s);
-	if (PyErr_Occurred())
-		PyErr_Clear();
+	EnvironmentObject *env = t->env;
+	PyGILState_STATE gstate;
+	size_t n, end;
+	int r = -1;
+	// A worker thread's GLPK environment may still hold a hook that has
+	// since been removed here, in which case just print normally.
+	if (env->term_hook == NULL)
+		return 0;
+	if (env->term_batch > 0 && term_buffer.data != NULL) {
+		n = strlen(s);
+		for (end = n; end > 0 && s[end-1] != '\n'; --end);
+		if (end == 0 && t->len + n <= ENVIRONMENT_LINE_SIZE) {
+			// The thread holds the line until it is ended.
+			PyThread_acquire_lock(term_buffer.mutex, WAIT_LOCK);
+			memcpy(t->line + t->len, s, n);
+			t->len += n;
+			PyThread_release_lock(term_buffer.mutex);
+			return 1;
+		}
+		// Part of a line too long to hold is passed on as it is.
+		if (end == 0 || n - end > ENVIRONMENT_LINE_SIZE)
+			end = n;
+		// Make room if need be, passing on even part of a line.
+		while (t->len + end <= TERM_BUFFER_SIZE &&
+		       (r = environment_term_append(t, s, n, end)) < 0) {
+			gstate = PyGILState_Ensure();
+			environment_term_deliver(env, 1);
+			PyGILState_Release(gstate);
+		}
+		if (r == 0)
+			return 1;
+		gstate = PyGILState_Ensure();
+		environment_term_deliver(env, r < 0);
+		if (r > 0) {
+			PyGILState_Release(gstate);
+			return 1;
+		}
+		// Output too long to ever be held is passed on by itself, after
+		// the part of a line the thread held.
+		PyThread_acquire_lock(term_buffer.mutex, WAIT_LOCK);
+		t->line[t->len] = 0;
+		t->len = 0;
+		PyThread_release_lock(term_buffer.mutex);
+		environment_term_call(env, t->line);
+	} else {
+		// The solver emitting this output may be running without the GIL.
+		gstate = PyGILState_Ensure();
+	}
+	environment_term_call(env, s);
+	PyGILState_Release(gstate);
 	return 1;
 }
 
+void Environment_FlushTerm(void)
+{
+	if (environment_instance != NULL &&
+	    (term_buffer.len > 0 || term_main.len > 0))
+		environment_term_deliver(environment_instance, 1);
+}
+
 static PyObject* Environment_gettermon(EnvironmentObject *self,void *closure)
 {
 	if (self->term_on)
@@ -189,6 +378,9 @@ static PyObject* Environment_gettermhook(EnvironmentObject *self,
 static int Environment_settermhook(EnvironmentObject *self,
 				   PyObject *value, void *closure)
 {
+	// Output held for the old hook goes to it.
+	if (term_buffer.len > 0 || term_main.len > 0)
+		environment_term_deliver(self, 1);
 	// Set the value of the internal terminal hook variable.
 	if (value==NULL || value==Py_None) {
 		if (self->term_hook) {
@@ -206,14 +398,117 @@ static int Environment_settermhook(EnvironmentObject *self,
 	}
 	// Next, set the hook with the glp_set_hook function.
 	if (self->term_hook) {
+		term_main.env = self;
 		glp_term_hook((int(*)(void*,const char*))environment_term_hook,
-				(void*)self);
+				(void*)&term_main);
 	} else {
 		glp_term_hook(NULL, NULL);
 	}
 	return 0;
 }
 
+static PyObject* Environment_gettermbatch(EnvironmentObject *self,
+					  void *closure)
+{
+	return PyInt_FromLong(self->term_batch);
+}
+
+static int Environment_settermbatch(EnvironmentObject *self,
+				    PyObject *value, void *closure)
+{
+	long batch = 0;
+	if (value != NULL && value != Py_None) {
+		if (!PyInt_Check(value)) {
+			PyErr_SetString(PyExc_TypeError, "term_batch must be int");
+			return -1;
+		}
+		if ((batch = PyInt_AsLong(value)) == -1 && PyErr_Occurred())
+			return -1;
+		if (batch < 0) {
+			PyErr_SetString(PyExc_ValueError,
+					"term_batch must be non-negative");
+			return -1;
+		}
+	}
+	if (batch > 0 && term_buffer.data == NULL) {
+		if (term_buffer.mutex == NULL &&
+		    (term_buffer.mutex = PyThread_allocate_lock()) == NULL) {
+			PyErr_NoMemory();
+			return -1;
+		}
+		if ((term_buffer.data = (char*)malloc(TERM_BUFFER_SIZE)) == NULL) {
+			PyErr_NoMemory();
+			return -1;
+		}
+	}
+	self->term_batch = batch < INT_MAX ? (int)batch : INT_MAX;
+	if (batch == 0 && (term_buffer.len > 0 || term_main.len > 0))
+		environment_term_deliver(self, 1);
+	return 0;
+}
+
+static PyObject* Environment_gettermint(EnvironmentObject *self,
+					void *closure)
+{
+	return PyFloat_FromDouble(self->term_interval);
+}
+
+static int Environment_settermint(EnvironmentObject *self,
+				  PyObject *value, void *closure)
+{
+	double interval;
+	if (value == NULL) {
+		PyErr_SetString(PyExc_AttributeError,
+				"term_interval cannot be deleted");
+		return -1;
+	}
+	if ((interval = PyFloat_AsDouble(value)) == -1.0 && PyErr_Occurred())
+		return -1;
+	if (!(interval >= 0.0)) {
+		PyErr_SetString(PyExc_ValueError,
+				"term_interval must be non-negative");
+		return -1;
+	}
+	self->term_interval = interval;
+	return 0;
+}
+
+static PyObject* Environment_termflush(EnvironmentObject *self)
+{
+	if (term_buffer.len > 0 || term_main.len > 0)
+		environment_term_deliver(self, 1);
+	Py_RETURN_NONE;
+}
+
+void Environment_InitThread(EnvironmentThread *thread)
+{
+	EnvironmentObject *env = environment_instance;
+	thread->env = NULL;
+	thread->len = 0;
+	if (env == NULL)
+		return;
+	if (env->mem_limit >= 0)
+		glp_mem_limit(env->mem_limit > 0 ? env->mem_limit : INT_MAX);
+	glp_term_out(env->term_on ? GLP_ON : GLP_OFF);
+	if (env->term_hook) {
+		thread->env = env;
+		glp_term_hook((int(*)(void*,const char*))environment_term_hook,
+				(void*)thread);
+	}
+}
+
+void Environment_EndThread(EnvironmentThread *thread)
+{
+	// The line is left unended, and passed on with the next batch.
+	if (thread->len == 0 || term_buffer.mutex == NULL)
+		return;
+	PyThread_acquire_lock(term_buffer.mutex, WAIT_LOCK);
+	if (thread->len <= TERM_BUFFER_SIZE - term_buffer.len)
+		environment_term_put(thread->line, thread->len);
+	thread->len = 0;
+	PyThread_release_lock(term_buffer.mutex);
+}
+
 /****************** OBJECT DEFINITION *********/
 
 int Environment_InitType(PyObject *module)
@@ -265,6 +560,24 @@ PyDoc_STRVAR(term_hook_doc,
 "function will go ignored and unreported."
 );
 
+PyDoc_STRVAR(term_batch_doc,
+"If positive, output for the terminal hook is held in a buffer and passed\n"
+"on in batches of whole lines, rather than upon each call GLPK makes,\n"
+"which may be part of a line. The hook is then called with a string of one\n"
+"or more lines once this many are held, or once the oldest has been held\n"
+"term_interval seconds, as checked when more output arrives. Output still\n"
+"held is passed on when a solver method returns, or by term_flush(). The\n"
+"buffer is filled without the GIL, so solvers running without it only\n"
+"take the GIL to deliver a batch, and each thread holds back the line it\n"
+"is writing until it ends it, so lines from solvers running on several\n"
+"threads are never mixed. 0 (the default) or None turns this off."
+);
+
+PyDoc_STRVAR(term_interval_doc,
+"The seconds a whole line of output may be held back when term_batch is\n"
+"set, 1.0 by default."
+);
+
 static PyGetSetDef Environment_getset[] = {
 	{"mem_limit", (getter)Environment_getmemlimit, (setter)Environment_setmemlimit,
 		mem_limit_doc, NULL},
@@ -280,15 +593,17 @@ static PyGetSetDef Environment_getset[] = {
 		term_on_doc, NULL},
 	{"term_hook",(getter)Environment_gettermhook,(setter)Environment_settermhook,
 		term_hook_doc, NULL},
+	{"term_batch", (getter)Environment_gettermbatch,
+		(setter)Environment_settermbatch, term_batch_doc, NULL},
+	{"term_interval", (getter)Environment_gettermint,
+		(setter)Environment_settermint, term_interval_doc, NULL},
 	{NULL}
 };
 
 static PyMethodDef Environment_methods[] = {
-	/*
-	 * {"foo", (PyCFunction)Environment_Foo, METH_NOARGS,
-	 * "foo()\n\n"
-	 * "Dummy function."},
-	 */
+	{"term_flush", (PyCFunction)Environment_termflush, METH_NOARGS,
+	"term_flush()\n\n"
+	"Pass any output held back by term_batch on to the terminal hook."},
 	{NULL}
 };
 
@@ -32,15 +32,42 @@ typedef struct {
 	int mem_limit;
 	unsigned int term_on:1;
 	PyObject *term_hook;
+	int term_batch; // Lines per batch for the hook, 0 if unbuffered.
+	double term_interval; // Seconds a whole line may be held back.
 	PyObject *version;
 	PyObject *weakreflist; // Weak reference list.
 } EnvironmentObject;
 
 extern PyTypeObject EnvironmentType;
 
+/* The longest part of a line a thread holds back from the terminal hook
+   until it ends the line, when term_batch is set. */
+#define ENVIRONMENT_LINE_SIZE 1024
+
+/* What the module keeps for the GLPK environment of a thread, which must
+   outlive it. */
+typedef struct {
+	EnvironmentObject *env; // Set if its output goes to the hook.
+	size_t len; // The length of the line held.
+	char line[ENVIRONMENT_LINE_SIZE + 1];
+} EnvironmentThread;
+
 /* Creates a new Environment object for controlling the GLPK environment. */
 EnvironmentObject* Environment_New(void);
 /* Init the type and related types it contains. 0 on success. */
 int Environment_InitType(PyObject *module);
+/* GLPK keeps a separate environment for each thread. This applies the
+   settings of the module's Environment instance (memory limit, terminal
+   output and hook) to the environment of the calling thread, e.g., a
+   worker thread about to run a solver, keeping its state in thread. Must
+   be called with the GIL. */
+void Environment_InitThread(EnvironmentThread *thread);
+/* Pass on what the thread holds once it is done with GLPK, before it
+   frees its GLPK environment. Does not need the GIL. */
+void Environment_EndThread(EnvironmentThread *thread);
+/* Passes on any terminal output held back for the terminal hook when
+   its delivery is batched, e.g., once a solver is done. Must be called
+   with the GIL. */
+void Environment_FlushTerm(void);
 
 #endif // _ENVIRONMENT_H
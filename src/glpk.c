@@ -20,6 +20,8 @@ along with PyGLPK.  If not, see <http://www.gnu.org/licenses/>.
 #include <Python.h>
 #include "lp.h"
 #include "environment.h"
+#include "solve.h"
+#include "cancel.h"
 
 #if PY_MAJOR_VERSION >= 3
 
@@ -70,6 +72,10 @@ MOD_INIT(glpk) {
 
   LPX_InitType(m);
 
+  Solve_InitModule(m);
+
+  Cancel_InitType(m);
+
   // Do a quick and dirty version check, so as to warn the user that
   // they should recompile PyGLPK if the underlying glpk shared
   // library has changed.
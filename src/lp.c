@@ -28,6 +28,12 @@ along with PyGLPK. If not, see <http://www.gnu.org/licenses/>.
 #include "kkt.h"
 #include "util.h"
 #include "tree.h"
+#include "solve.h"
+#include "environment.h"
+#include "cancel.h"
+#include "snapshot.h"
+#include <limits.h>
+#include <string.h>
 
 #ifdef USEPARAMS
 #include "params.h"
@@ -79,6 +85,8 @@ LPXObject* LPX_FromLP(glp_prob*lp)
 	lpx->cols = lpx->rows = NULL;
 	lpx->obj = NULL;
 	lpx->params = NULL;
+	lpx->solving = 0;
+	lpx->foreign = 0;
 	// Try assigning the values.
 	if ((lpx->cols = (PyObject*)BarCol_New(lpx, 0)) == NULL || (lpx->rows = (PyObject*)BarCol_New(lpx, 1)) == NULL ||
 #ifdef USEPARAMS
@@ -108,10 +116,70 @@ static PyObject * LPX_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 #endif
 		self->weakreflist = NULL;
 		self->last_solver = -1;
+		self->solving = 0;
+		self->foreign = 0;
 	}
 	return (PyObject*)self;
 }
 
+/* The problem data formats, as keywords of LPX() and LPX.write, and the
+   names of their readers in error messages. */
+static const char *lpx_formats[] = {"mps", "freemps", "cpxlp", "glp", NULL};
+static const char *lpx_readers[] = {"MPS", "Free MPS", "CPLEX LP",
+	"GLPK LP/MIP"};
+
+/* The index of the named format, or -1 with an exception set. */
+static int lpx_format(const char *name)
+{
+	int i;
+	for (i = 0; lpx_formats[i]; ++i)
+		if (!strcmp(name, lpx_formats[i]))
+			return i;
+	PyErr_Format(PyExc_ValueError, "format '%s' unrecognized (mps, "
+		     "freemps, cpxlp and glp are valid values)", name);
+	return -1;
+}
+
+/* Read problem data in the format from the file. Returns 0 with an
+   exception set on failure. */
+static int lpx_read_format(glp_prob *lp, int format, const char *fname)
+{
+	int failure;
+	switch (format) {
+	case 0:
+		failure = glp_read_mps(lp, GLP_MPS_DECK, NULL, fname);
+		break;
+	case 1:
+		failure = glp_read_mps(lp, GLP_MPS_FILE, NULL, fname);
+		break;
+	case 2:
+		failure = glp_read_lp(lp, NULL, fname);
+		break;
+	default:
+		failure = glp_read_prob(lp, 0, fname);
+		break;
+	}
+	if (failure)
+		PyErr_Format(PyExc_RuntimeError, "%s reader failed",
+			     lpx_readers[format]);
+	return !failure;
+}
+
+/* Write problem data in the format to the file. Returns 0 on failure. */
+static int lpx_write_format(glp_prob *lp, int format, const char *fname)
+{
+	switch (format) {
+	case 0:
+		return !glp_write_mps(lp, GLP_MPS_DECK, NULL, fname);
+	case 1:
+		return !glp_write_mps(lp, GLP_MPS_FILE, NULL, fname);
+	case 2:
+		return !glp_write_lp(lp, NULL, fname);
+	default:
+		return !glp_write_prob(lp, 0, fname);
+	}
+}
+
 static int LPX_init(LPXObject *self, PyObject *args, PyObject *kwds)
 {
 	char *mps_n=NULL, *freemps_n=NULL, *cpxlp_n=NULL, *glp_n=NULL;
@@ -162,21 +230,13 @@ static int LPX_init(LPXObject *self, PyObject *args, PyObject *kwds)
 	self->lp = glp_create_prob();
 	// Some of these are pretty straightforward data reading routines.
 	if (mps_n) {
-		failure = glp_read_mps(self->lp, GLP_MPS_DECK, NULL, mps_n);
-		if (failure)
-			PyErr_SetString(PyExc_RuntimeError, "MPS reader failed");
+		failure = !lpx_read_format(self->lp, 0, mps_n);
 	} else if (freemps_n) {
-		failure = glp_read_mps(self->lp, GLP_MPS_FILE, NULL, freemps_n);
-		if (failure)
-			PyErr_SetString(PyExc_RuntimeError, "Free MPS reader failed");
+		failure = !lpx_read_format(self->lp, 1, freemps_n);
 	} else if (cpxlp_n) {
-		failure = glp_read_lp(self->lp, NULL, cpxlp_n);
-		if (failure)
-			PyErr_SetString(PyExc_RuntimeError, "CPLEX LP reader failed");
+		failure = !lpx_read_format(self->lp, 2, cpxlp_n);
 	} else if (glp_n) {
-		failure = glp_read_prob(self->lp, 0, glp_n);
-		if (failure)
-			PyErr_SetString(PyExc_RuntimeError, "GLPK LP/MIP reader failed");
+		failure = !lpx_read_format(self->lp, 3, glp_n);
 	} else if (model_obj) {
 		/* allocate the translator workspace */
 		tran = glp_mpl_alloc_wksp();
@@ -271,6 +331,8 @@ int LPX_SetMatrix(LPXObject *self, PyObject *newvals)
 {
 	int len, *ind1 = NULL, *ind2 = NULL;
 	double *val = NULL;
+	if (!LPX_CheckChange(self))
+		return -1;
 	// Now, attempt to convert the input item.
 	if (newvals == NULL || newvals == Py_None)
 		len = 0;
@@ -290,6 +352,139 @@ int LPX_SetMatrix(LPXObject *self, PyObject *newvals)
 
 /****************** METHODS ***************/
 
+/*
+ * Export the constraint matrix in compressed sparse row (byrow) or column
+ * form.  The entries are bucketed by a pass over the opposite dimension, so
+ * the minor indices come out sorted without any sorting.
+ */
+static PyObject* LPX_matrix_compressed(LPXObject *self, int byrow)
+{
+	int (*get_major)(glp_prob *, int, int[], double[]) =
+		byrow ? glp_get_mat_row : glp_get_mat_col;
+	int (*get_minor)(glp_prob *, int, int[], double[]) =
+		byrow ? glp_get_mat_col : glp_get_mat_row;
+	int nmajor = byrow ? glp_get_num_rows(LP) : glp_get_num_cols(LP);
+	int nminor = byrow ? glp_get_num_cols(LP) : glp_get_num_rows(LP);
+	int nnz = glp_get_num_nz(LP), i, j, len, *ind, *indptr, *indices, *next;
+	double *val, *data;
+	PyObject *ptrob, *indob, *dataob, *retval;
+
+	ptrob = util_new_buffer("i", nmajor + 1, (void**)&indptr);
+	indob = util_new_buffer("i", nnz, (void**)&indices);
+	dataob = util_new_buffer("d", nnz, (void**)&data);
+	ind = (int*)calloc(nmajor + 1, sizeof(int));
+	val = (double*)calloc(nmajor + 1, sizeof(double));
+	next = (int*)calloc(nmajor + 1, sizeof(int));
+	if (ptrob == NULL || indob == NULL || dataob == NULL) {
+		retval = NULL;
+		goto done;
+	}
+	if (ind == NULL || val == NULL || next == NULL) {
+		retval = PyErr_NoMemory();
+		goto done;
+	}
+	// Lay out the start of each major vector from its length.
+	indptr[0] = 0;
+	for (i = 1; i <= nmajor; ++i)
+		indptr[i] = indptr[i-1] + get_major(LP, i, NULL, NULL);
+	memcpy(next, indptr, nmajor * sizeof(int));
+	// Walk the minor vectors in order, dropping entries into place.
+	for (j = 1; j <= nminor; ++j) {
+		len = get_minor(LP, j, ind-1, val-1);
+		for (i = 0; i < len; ++i) {
+			int k = next[ind[i]-1]++;
+			indices[k] = j - 1;
+			data[k] = val[i];
+		}
+	}
+	retval = PyTuple_Pack(3, ptrob, indob, dataob);
+done:
+	free(ind);
+	free(val);
+	free(next);
+	Py_XDECREF(ptrob);
+	Py_XDECREF(indob);
+	Py_XDECREF(dataob);
+	return retval;
+}
+
+static PyObject* LPX_MatrixCSR(LPXObject *self)
+{
+	return LPX_matrix_compressed(self, 1);
+}
+
+static PyObject* LPX_MatrixCSC(LPXObject *self)
+{
+	return LPX_matrix_compressed(self, 0);
+}
+
+static PyObject* LPX_LoadMatrix(LPXObject *self, PyObject *args)
+{
+	PyObject *rowob, *colob, *valob;
+	Py_buffer rows, cols, vals;
+	int *ia = NULL, *ja = NULL, ne, k;
+	double *ar = NULL, *arcopy = NULL;
+	PyObject *retval = NULL;
+
+	if (!LPX_CheckChange(self))
+		return NULL;
+	if (!PyArg_ParseTuple(args, "OOO", &rowob, &colob, &valob))
+		return NULL;
+	if (!util_buffer_get(rowob, "row indices", &rows))
+		return NULL;
+	if (!util_buffer_get(colob, "column indices", &cols)) {
+		PyBuffer_Release(&rows);
+		return NULL;
+	}
+	if (!util_buffer_get(valob, "values", &vals)) {
+		PyBuffer_Release(&rows);
+		PyBuffer_Release(&cols);
+		return NULL;
+	}
+	if (util_buffer_len(&rows) != util_buffer_len(&cols) ||
+	    util_buffer_len(&rows) != util_buffer_len(&vals)) {
+		PyErr_SetString(PyExc_ValueError,
+				"row indices, column indices and values must have "
+				"the same length");
+		goto done;
+	}
+	if (util_buffer_len(&rows) > INT_MAX) {
+		PyErr_SetString(PyExc_OverflowError, "too many matrix entries");
+		goto done;
+	}
+	ne = (int)util_buffer_len(&rows);
+	// Convert the indices to GLPK's 1-based convention.
+	if ((ia = util_buffer_ints(&rows, "row indices", 1)) == NULL ||
+	    (ja = util_buffer_ints(&cols, "column indices", 1)) == NULL ||
+	    (ar = util_buffer_doubles(&vals, "values", &arcopy)) == NULL)
+		goto done;
+
+	// glp_load_matrix aborts on bad input, so check it here first.
+	k = glp_check_dup(glp_get_num_rows(LP), glp_get_num_cols(LP),
+			  ne, ia-1, ja-1);
+	if (k < 0) {
+		PyErr_Format(PyExc_IndexError, "matrix index %d,%d out of range",
+			     ia[-k-1]-1, ja[-k-1]-1);
+		goto done;
+	}
+	if (k > 0) {
+		PyErr_Format(PyExc_ValueError, "duplicate index %d,%d detected",
+			     ia[k-1]-1, ja[k-1]-1);
+		goto done;
+	}
+	glp_load_matrix(LP, ne, ia-1, ja-1, ar-1);
+	retval = Py_None;
+	Py_INCREF(retval);
+done:
+	free(ia);
+	free(ja);
+	free(arcopy);
+	PyBuffer_Release(&rows);
+	PyBuffer_Release(&cols);
+	PyBuffer_Release(&vals);
+	return retval;
+}
+
 /*static PyObject* LPX_OrderMatrix(LPXObject *self) {
   glp_order_matrix(LP);
   Py_RETURN_NONE;
@@ -297,6 +492,8 @@ int LPX_SetMatrix(LPXObject *self, PyObject *newvals)
 
 static PyObject* LPX_Erase(LPXObject *self)
 {
+	if (!LPX_CheckChange(self))
+		return NULL;
 	glp_erase_prob(LP);
 	Py_RETURN_NONE;
 }
@@ -315,6 +512,8 @@ static PyObject* LPX_Copy(LPXObject *self, PyObject *args)
 static PyObject* LPX_Scale(LPXObject *self, PyObject*args)
 {
 	int flags = GLP_SF_AUTO;
+	if (!LPX_CheckChange(self))
+		return NULL;
 	PyArg_ParseTuple(args, "|i", &flags);
 	glp_scale_prob(LP, flags);
 	Py_RETURN_NONE;
@@ -322,31 +521,80 @@ static PyObject* LPX_Scale(LPXObject *self, PyObject*args)
 
 static PyObject* LPX_Unscale(LPXObject *self)
 {
+	if (!LPX_CheckChange(self))
+		return NULL;
 	glp_unscale_prob(LP);
 	Py_RETURN_NONE;
 }
 
 static PyObject* LPX_basis_std(LPXObject *self)
 {
+	if (!LPX_CheckChange(self))
+		return NULL;
 	glp_std_basis(LP);
 	Py_RETURN_NONE;
 }
 
 static PyObject* LPX_basis_adv(LPXObject *self)
 {
+	if (!LPX_CheckChange(self))
+		return NULL;
 	glp_adv_basis(LP, 0);
 	Py_RETURN_NONE;
 }
 
 static PyObject* LPX_basis_cpx(LPXObject *self)
 {
+	if (!LPX_CheckChange(self))
+		return NULL;
 	glp_cpx_basis(LP);
 	Py_RETURN_NONE;
 }
 
 /**************** SOLVER METHODS **************/
 
-static PyObject* glpsolver_retval_to_message(int retval)
+/*
+ * Runs a GLPK solver call. If nogil is set the GIL is released for the
+ * duration of the call, so that other Python threads may run while GLPK
+ * works. Any Python code reached from within GLPK (the MIP callback or the
+ * terminal hook) reacquires the GIL itself. Batched terminal output still
+ * held afterwards is passed on.
+ */
+#define SOLVE(nogil, call)			\
+	do {					\
+		if (nogil) {			\
+			Py_BEGIN_ALLOW_THREADS	\
+			call;			\
+			Py_END_ALLOW_THREADS	\
+		} else {			\
+			call;			\
+		}				\
+		Environment_FlushTerm();	\
+	} while (0)
+
+int LPX_CheckChange(LPXObject *self)
+{
+	if (self->foreign) {
+		PyErr_SetString(PyExc_RuntimeError, "problem cannot be changed "
+				"from the callback of an asynchronous solve");
+		return 0;
+	}
+	return 1;
+}
+
+int LPX_BeginSolve(LPXObject *self)
+{
+	if (!LPX_CheckChange(self))
+		return 0;
+	if (self->solving) {
+		PyErr_SetString(PyExc_RuntimeError, "a solver is already running on this problem");
+		return 0;
+	}
+	self->solving = 1;
+	return 1;
+}
+
+PyObject* glpsolver_retval_to_message(int retval)
 {
 	const char* returnval = NULL;
 	switch (retval) {
@@ -389,30 +637,30 @@ static PyObject* glpsolver_retval_to_message(int retval)
 	return PyString_FromString(returnval);
 }
 
-static PyObject* LPX_solver_simplex(LPXObject *self, PyObject *args,
-				    PyObject *keywds)
+int LPX_ParseSmcp(PyObject *args, PyObject *kwds, glp_smcp *cp,
+		  PyObject **cancel, int *nogil)
 {
-	glp_smcp cp;
 	/*
 	 * Set all to GLPK defaults, except for the message level, which
 	 * inexplicably has a default "verbose" setting.
 	 */
-	glp_init_smcp(&cp);
-	cp.msg_lev = GLP_MSG_OFF;
+	glp_init_smcp(cp);
+	cp->msg_lev = GLP_MSG_OFF;
 	// Map the keyword arguments to the appropriate entries.
 	static char *kwlist[] = {"msg_lev", "meth", "pricing", "r_test",
 		"tol_bnd", "tol_dj", "tol_piv", "obj_ll", "obj_ul", "it_lim",
-		"tm_lim", "out_frq", "out_dly", "presolve", NULL};
-	if (!PyArg_ParseTupleAndKeywords(args, keywds, "|iiiidddddiiiii",
-				kwlist, &cp.msg_lev, &cp.meth, &cp.pricing,
-				&cp.r_test, &cp.tol_bnd, &cp.tol_dj,
-				&cp.tol_piv, &cp.obj_ll, &cp.obj_ul, &cp.it_lim,
-				&cp.tm_lim, &cp.out_frq, &cp.out_dly,
-				&cp.presolve))
-		return NULL;
-	cp.presolve = cp.presolve ? GLP_ON : GLP_OFF;
+		"tm_lim", "out_frq", "out_dly", "presolve", "nogil", "cancel",
+		NULL};
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iiiidddddiiiiiiO&",
+				kwlist, &cp->msg_lev, &cp->meth, &cp->pricing,
+				&cp->r_test, &cp->tol_bnd, &cp->tol_dj,
+				&cp->tol_piv, &cp->obj_ll, &cp->obj_ul, &cp->it_lim,
+				&cp->tm_lim, &cp->out_frq, &cp->out_dly,
+				&cp->presolve, nogil, Cancel_Converter, cancel))
+		return 0;
+	cp->presolve = cp->presolve ? GLP_ON : GLP_OFF;
 	// Do checking on the various entries.
-	switch (cp.msg_lev) {
+	switch (cp->msg_lev) {
 	case GLP_MSG_OFF:
 	case GLP_MSG_ERR:
 	case GLP_MSG_ON:
@@ -420,9 +668,9 @@ static PyObject* LPX_solver_simplex(LPXObject *self, PyObject *args,
 		break;
 	default:
 		PyErr_SetString(PyExc_ValueError, "invalid value for msg_lev (LPX.MSG_* are valid values)");
-		return NULL;
+		return 0;
 	}
-	switch (cp.meth) {
+	switch (cp->meth) {
 	case GLP_PRIMAL:
 	case GLP_DUALP:
 		break;
@@ -430,139 +678,199 @@ static PyObject* LPX_solver_simplex(LPXObject *self, PyObject *args,
 		break;
 	default:
 		PyErr_SetString(PyExc_ValueError, "invalid value for meth (LPX.PRIMAL, LPX.DUAL, LPX.DUALP valid values)");
-		return NULL;
+		return 0;
 	}
-	switch (cp.pricing) {
+	switch (cp->pricing) {
 	case GLP_PT_STD:
 	case GLP_PT_PSE:
 		break;
 	default:
 		PyErr_SetString(PyExc_ValueError, "invalid value for pricing (LPX.PT_STD, LPX.PT_PSE valid values)");
-		return NULL;
+		return 0;
 	}
-	switch (cp.r_test) {
+	switch (cp->r_test) {
 		case GLP_RT_STD:
 		case GLP_RT_HAR:
 			break;
 		default:
 			PyErr_SetString(PyExc_ValueError, "invalid value for ratio test (LPX.RT_STD, LPX.RT_HAR valid values)");
-			return NULL;
+			return 0;
 	}
-	if (cp.tol_bnd <= 0 || cp.tol_bnd >= 1) {
+	if (cp->tol_bnd <= 0 || cp->tol_bnd >= 1) {
 		PyErr_SetString(PyExc_ValueError, "tol_bnd must obey 0<tol_bnd<1");
-		return NULL;
+		return 0;
 	}
-	if (cp.tol_dj <= 0 || cp.tol_dj >= 1) {
+	if (cp->tol_dj <= 0 || cp->tol_dj >= 1) {
 		PyErr_SetString(PyExc_ValueError, "tol_dj must obey 0<tol_dj<1");
-		return NULL;
+		return 0;
 	}
-	if (cp.tol_piv <= 0 || cp.tol_piv >= 1) {
+	if (cp->tol_piv <= 0 || cp->tol_piv >= 1) {
 		PyErr_SetString(PyExc_ValueError, "tol_piv must obey 0<tol_piv<1");
-		return NULL;
+		return 0;
 	}
-	if (cp.it_lim < 0) {
+	if (cp->it_lim < 0) {
 		PyErr_SetString(PyExc_ValueError, "it_lim must be non-negative");
-		return NULL;
+		return 0;
 	}
-	if (cp.tm_lim < 0) {
+	if (cp->tm_lim < 0) {
 		PyErr_SetString(PyExc_ValueError, "tm_lim must be non-negative");
-		return NULL;
+		return 0;
 	}
-	if (cp.out_frq <= 0) {
+	if (cp->out_frq <= 0) {
 		PyErr_SetString(PyExc_ValueError, "out_frq must be positive");
-		return NULL;
+		return 0;
 	}
-	if (cp.out_dly < 0) {
+	if (cp->out_dly < 0) {
 		PyErr_SetString(PyExc_ValueError, "out_dly must be non-negative");
-		return NULL;
+		return 0;
 	}
+	return 1;
+}
+
+static PyObject* LPX_solver_simplex(LPXObject *self, PyObject *args,
+				    PyObject *keywds)
+{
+	glp_smcp cp;
+	PyObject *cancel = NULL;
+	int nogil = 0;
+	if (!LPX_ParseSmcp(args, keywds, &cp, &cancel, &nogil))
+		return NULL;
 	// All the checks are complete. Call the simplex solver.
-	int retval = glp_simplex(LP, &cp);
+	int retval;
+	if (!LPX_BeginSolve(self))
+		return NULL;
+	SOLVE(nogil, retval = Solve_Simplex(LP, &cp, 0, cancel));
+	self->solving = 0;
 	if (retval != GLP_EBADB && retval != GLP_ESING && retval != GLP_ECOND && retval != GLP_EBOUND && retval != GLP_EFAIL)
 		self->last_solver = 0;
-	return glpsolver_retval_to_message(retval);
+	return Cancel_Message(retval, retval == GLP_ESTOP);
 }
 
-static PyObject* LPX_solver_exact(LPXObject *self)
+static PyObject* LPX_solver_exact(LPXObject *self, PyObject *args,
+				  PyObject *keywds)
 {
-	int retval;
+	int retval, nogil = 0;
 	glp_smcp parm;
+	PyObject *cancel = NULL;
+	static char *kwlist[] = {"nogil", "cancel", NULL};
 
+	if (!PyArg_ParseTupleAndKeywords(args, keywds, "|iO&", kwlist, &nogil,
+					 Cancel_Converter, &cancel))
+		return NULL;
         //TODO: add kwargs for smcp
 	glp_init_smcp(&parm);
-	retval = glp_exact(LP, &parm);
+	if (!LPX_BeginSolve(self))
+		return NULL;
+	SOLVE(nogil, retval = Solve_Simplex(LP, &parm, 1, cancel));
+	self->solving = 0;
 	if (!retval)
 		self->last_solver = 0;
-	return glpsolver_retval_to_message(retval);
+	return Cancel_Message(retval, retval == GLP_ESTOP);
 }
 
-static PyObject* LPX_solver_interior(LPXObject *self) {
-	int retval = glp_interior(LP, NULL);
+static PyObject* LPX_solver_interior(LPXObject *self, PyObject *args,
+				     PyObject *keywds) {
+	int retval, nogil = 0;
+	PyObject *cancel = NULL;
+	static char *kwlist[] = {"nogil", "cancel", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, keywds, "|iO&", kwlist, &nogil,
+					 Cancel_Converter, &cancel))
+		return NULL;
+	// This cannot be interrupted, so is only cancelled before starting.
+	if (Cancel_Check(cancel))
+		return Cancel_Message(GLP_ESTOP, 1);
+	if (!LPX_BeginSolve(self))
+		return NULL;
+	SOLVE(nogil, retval = glp_interior(LP, NULL));
+	self->solving = 0;
 	if (!retval)
 		self->last_solver = 1;
 	return glpsolver_retval_to_message(retval);
 }
 
 struct mip_callback_object {
-	PyObject *callback;
+	LPXMipCallback cb;
+	void (*cb_func)(glp_tree*, void*); // A capsule's, run instead.
+	void *cb_info;
+	PyObject *cancel;
 	LPXObject *py_lp;
+	Search search;
 };
 
-static void mip_callback(glp_tree *tree, void *info)
+int LPX_MipCallbackInit(LPXMipCallback *cb, PyObject *callback)
 {
-	struct mip_callback_object *obj = (struct mip_callback_object *)info;
-	PyObject *method_name = NULL;
-	// Choose the method name for the callback object that is appropriate.
-	switch (glp_ios_reason(tree)) {
-	case GLP_ISELECT:
-		method_name = PyString_FromString("select");
-		break;
-	case GLP_IPREPRO:
-		method_name = PyString_FromString("prepro");
-		break;
-	case GLP_IBRANCH:
-		method_name = PyString_FromString("branch");
-		break;
-	case GLP_IROWGEN:
-		method_name = PyString_FromString("rowgen");
-		break;
-	case GLP_IHEUR:
-		method_name = PyString_FromString("heur");
-		break;
-	case GLP_ICUTGEN:
-		method_name = PyString_FromString("cutgen");
-		break;
-	case GLP_IBINGO:
-		method_name = PyString_FromString("bingo");
-		break;
-	default:
-		// This should never happen.
-		PyErr_SetString(PyExc_RuntimeError, "unrecognized reason for callback");
-		glp_ios_terminate(tree);
-		return;
-	}
-	// If there is no method with that name.
-	if (!PyObject_HasAttr(obj->callback, method_name)) {
-		Py_DECREF(method_name);
-		method_name=PyString_FromString("default");
-		if (!PyObject_HasAttr(obj->callback, method_name)) {
-			Py_DECREF(method_name);
-			method_name = NULL;
-			return;
+	static const char *names[LPX_MIP_REASONS] = {NULL, "select", "prepro",
+		"rowgen", "heur", "cutgen", "branch", "bingo"};
+	PyObject *method, *fallback;
+	int reason;
+
+	memset(cb, 0, sizeof(*cb));
+	if (callback == NULL)
+		return 1;
+	// A missing method is not an error, but any other failure is.
+	if ((fallback = PyObject_GetAttrString(callback, "default")) == NULL) {
+		if (!PyErr_ExceptionMatches(PyExc_AttributeError))
+			return 0;
+		PyErr_Clear();
+	}
+	for (reason = 0; reason < LPX_MIP_REASONS; ++reason) {
+		if (names[reason] == NULL)
+			continue;
+		method = PyObject_GetAttrString(callback, names[reason]);
+		if (method == NULL) {
+			if (!PyErr_ExceptionMatches(PyExc_AttributeError)) {
+				Py_XDECREF(fallback);
+				LPX_MipCallbackClear(cb);
+				return 0;
+			}
+			PyErr_Clear();
+			Py_XINCREF(method = fallback);
 		}
+		if ((cb->methods[reason] = method) != NULL)
+			cb->mask |= 1u << reason;
 	}
-	// Try calling the method.
-	TreeObject *py_tree = Tree_New(tree, obj->py_lp);
-	if (py_tree == NULL) {
-		Py_DECREF(method_name);
-		glp_ios_terminate(tree);
-		return;
+	Py_XDECREF(fallback);
+	return 1;
+}
+
+static void mip_callback_drop_tree(LPXMipCallback *cb)
+{
+	if (cb->tree != NULL && cb->wrapped) {
+		// The presolver's problem belongs to the solver, not to us.
+		((TreeObject*)cb->tree)->py_lp->lp = NULL;
 	}
-	PyObject *retval = NULL;
-	retval = PyObject_CallMethodObjArgs(obj->callback, method_name, py_tree, NULL);
+	Py_CLEAR(cb->tree);
+}
+
+void LPX_CallMipCallback(LPXMipCallback *cb, glp_tree *tree,
+			 LPXObject *py_lp)
+{
+	TreeObject *py_tree = (TreeObject*)cb->tree;
+	PyObject *retval;
+
+	/* The Tree is made once, unless the problem it wraps changes, and
+	 * is revalidated for each call. */
+	if (py_tree == NULL || py_tree->py_lp->lp != glp_ios_get_prob(tree)) {
+		mip_callback_drop_tree(cb);
+		if ((py_tree = Tree_New(tree, py_lp)) == NULL) {
+			glp_ios_terminate(tree);
+			return;
+		}
+		cb->tree = (PyObject*)py_tree;
+		cb->wrapped = py_tree->py_lp != py_lp;
+	}
+	py_tree->tree = tree;
+	py_tree->selected = 0;
+	py_tree->branched = 0;
+	py_tree->foreign = cb->foreign;
+	/* The solver's own problem stays unchangeable from this thread, also
+	 * should the callback keep a reference to it. */
+	if (cb->foreign)
+		py_tree->py_lp->foreign = 1;
+	retval = PyObject_CallFunctionObjArgs(
+		cb->methods[glp_ios_reason(tree)], (PyObject*)py_tree, NULL);
 	py_tree->tree = NULL; // Invalidate the Tree object.
-	Py_DECREF(py_tree);
-	Py_XDECREF(method_name);
 	if (retval == NULL) {
 		/* This could have failed for any number of reasons. Perhaps the
 		 * code within the method failed, perhaps the method does not
@@ -575,14 +883,81 @@ static void mip_callback(glp_tree *tree, void *info)
 	Py_DECREF(retval);
 }
 
-static PyObject* LPX_solver_integer(LPXObject *self, PyObject *args,
-		PyObject *keywds)
+int LPX_MipCallbackActed(LPXMipCallback *cb, int reason)
 {
-	PyObject *callback = NULL;
-	struct mip_callback_object*info = NULL;
-	glp_iocp cp;
-	glp_init_iocp(&cp);
-	cp.msg_lev = GLP_MSG_OFF;
+	TreeObject *py_tree = (TreeObject*)cb->tree;
+	return LPX_MipCallbackHandles(cb, reason) && py_tree != NULL &&
+		(py_tree->selected || py_tree->branched);
+}
+
+void LPX_MipCallbackClear(LPXMipCallback *cb)
+{
+	int reason;
+	for (reason = 0; reason < LPX_MIP_REASONS; ++reason)
+		Py_CLEAR(cb->methods[reason]);
+	cb->mask = 0;
+	mip_callback_drop_tree(cb);
+}
+
+int LPX_MipCallbackCapsule(PyObject *callback, glp_iocp *cp)
+{
+	const char *name;
+	void *func, *context;
+	if (callback == NULL || !PyCapsule_CheckExact(callback))
+		return 0;
+	name = PyCapsule_GetName(callback);
+	if (name == NULL) {
+		if (!PyErr_Occurred())
+			PyErr_Format(PyExc_ValueError, "callback capsule must "
+				     "be named '%s'", LPX_MIP_CAPSULE);
+		return -1;
+	}
+	if (strcmp(name, LPX_MIP_CAPSULE)) {
+		PyErr_Format(PyExc_ValueError, "callback capsule must be named "
+			     "'%s', not '%.200s'", LPX_MIP_CAPSULE, name);
+		return -1;
+	}
+	if ((func = PyCapsule_GetPointer(callback, name)) == NULL)
+		return -1;
+	context = PyCapsule_GetContext(callback);
+	if (context == NULL && PyErr_Occurred())
+		return -1;
+	cp->cb_func = (void (*)(glp_tree*, void*))func;
+	cp->cb_info = context;
+	return 1;
+}
+
+static void mip_callback(glp_tree *tree, void *info)
+{
+	struct mip_callback_object *obj = (struct mip_callback_object *)info;
+	PyGILState_STATE gstate;
+	int reason = glp_ios_reason(tree);
+	if (Cancel_Check(obj->cancel)) {
+		glp_ios_terminate(tree);
+		return;
+	}
+	if (obj->cb_func != NULL) {
+		obj->cb_func(tree, obj->cb_info);
+	} else if (LPX_MipCallbackHandles(&obj->cb, reason)) {
+		// The solver may be running with the GIL released.
+		gstate = PyGILState_Ensure();
+		LPX_CallMipCallback(&obj->cb, tree, obj->py_lp);
+		PyGILState_Release(gstate);
+	}
+	Search_Callback(&obj->search, tree,
+			LPX_MipCallbackActed(&obj->cb, reason));
+	// The callback may have cancelled the token itself.
+	if (Cancel_Check(obj->cancel))
+		glp_ios_terminate(tree);
+}
+
+int LPX_ParseIocp(PyObject *args, PyObject *kwds, glp_iocp *cp,
+		  PyObject **callback, PyObject **cancel, int *nogil,
+		  Search *search)
+{
+	glp_init_iocp(cp);
+	Search_Init(search);
+	cp->msg_lev = GLP_MSG_OFF;
 	// Map the keyword arguments to the appropriate entries.
 	static char *kwlist[] = {"msg_lev", // int
 		"br_tech", 		// int
@@ -608,60 +983,73 @@ static PyObject* LPX_solver_integer(LPXObject *self, PyObject *args,
 		//"cb_info", "cb_size",
 		"presolve", 	// int
 		"binarize", 	// int
+		"nogil",	// int
+		"cancel",	// CancelToken
+		"sel_tech",	// int
+		"sel_frq",	// int
+		"sel_gap",	// double
+		"sb_tech",	// int
+		"sb_cand",	// int
+		"sb_it_lim",	// int
+		"sb_rel",	// int
 		NULL};
-	if (!PyArg_ParseTupleAndKeywords(args, keywds, 
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, 
 #if GLP_MAJOR_VERSION >=4 && GLP_MINOR_VERSION >= 57
-	"|iiiiiiiiiiiidddiiiOii",
+	"|iiiiiiiiiiiidddiiiOiiiO&iidiiii",
 #else
-	"|iiiiiiiiiiidddiiiOii",
+	"|iiiiiiiiiiidddiiiOiiiO&iidiiii",
 #endif
 			kwlist,
-			&cp.msg_lev, 
-			&cp.br_tech, 
-			&cp.bt_tech,
-			&cp.pp_tech,
+			&cp->msg_lev, 
+			&cp->br_tech, 
+			&cp->bt_tech,
+			&cp->pp_tech,
 #if GLP_MAJOR_VERSION >= 4 && GLP_MINOR_VERSION >= 57
-			&cp.sr_heur,
+			&cp->sr_heur,
 #endif
-			&cp.fp_heur,
-			&cp.ps_heur,
-			&cp.ps_tm_lim,
-			&cp.gmi_cuts,
-			&cp.mir_cuts,
-			&cp.cov_cuts,
-			&cp.clq_cuts,
-			&cp.tol_int, 
-			&cp.tol_obj, 
-			&cp.mip_gap,
-			&cp.tm_lim,
-			&cp.out_frq, 
-			&cp.out_dly, 
-			&callback,
-			&cp.presolve,
-			&cp.binarize)) {
-		return NULL;
+			&cp->fp_heur,
+			&cp->ps_heur,
+			&cp->ps_tm_lim,
+			&cp->gmi_cuts,
+			&cp->mir_cuts,
+			&cp->cov_cuts,
+			&cp->clq_cuts,
+			&cp->tol_int, 
+			&cp->tol_obj, 
+			&cp->mip_gap,
+			&cp->tm_lim,
+			&cp->out_frq, 
+			&cp->out_dly, 
+			callback,
+			&cp->presolve,
+			&cp->binarize,
+			nogil,
+			Cancel_Converter, cancel,
+			&search->sel_tech,
+			&search->sel_frq,
+			&search->sel_gap,
+			&search->sb_tech,
+			&search->sb_cand,
+			&search->sb_it_lim,
+			&search->sb_rel)) {
+		return 0;
 	}
 
 	// Convert on/off parameters. 
 #if GLP_MAJOR_VERSION >= 4 && GLP_MINOR_VERSION >= 57
-	cp.sr_heur = cp.sr_heur ? GLP_ON : GLP_OFF;
+	cp->sr_heur = cp->sr_heur ? GLP_ON : GLP_OFF;
 #endif
-	cp.fp_heur = cp.fp_heur ? GLP_ON : GLP_OFF;
-	cp.ps_heur = cp.ps_heur ? GLP_ON : GLP_OFF;
-	cp.gmi_cuts = cp.gmi_cuts ? GLP_ON : GLP_OFF;
-	cp.mir_cuts = cp.mir_cuts ? GLP_ON : GLP_OFF;
-	cp.cov_cuts = cp.cov_cuts ? GLP_ON : GLP_OFF;
-	cp.clq_cuts = cp.clq_cuts ? GLP_ON : GLP_OFF;
-	cp.presolve = cp.presolve ? GLP_ON : GLP_OFF;
-	cp.binarize = cp.binarize ? GLP_ON : GLP_OFF;
-
-	if ((cp.presolve == GLP_OFF) && (glp_get_status(LP) != GLP_OPT)) {
-		PyErr_SetString(PyExc_RuntimeError, "integer solver without presolve requires existing optimal basic solution");
-		return NULL;
-	}
+	cp->fp_heur = cp->fp_heur ? GLP_ON : GLP_OFF;
+	cp->ps_heur = cp->ps_heur ? GLP_ON : GLP_OFF;
+	cp->gmi_cuts = cp->gmi_cuts ? GLP_ON : GLP_OFF;
+	cp->mir_cuts = cp->mir_cuts ? GLP_ON : GLP_OFF;
+	cp->cov_cuts = cp->cov_cuts ? GLP_ON : GLP_OFF;
+	cp->clq_cuts = cp->clq_cuts ? GLP_ON : GLP_OFF;
+	cp->presolve = cp->presolve ? GLP_ON : GLP_OFF;
+	cp->binarize = cp->binarize ? GLP_ON : GLP_OFF;
 
 	// Do checking on the various entries.
-	switch (cp.msg_lev) {
+	switch (cp->msg_lev) {
 	case GLP_MSG_OFF:
 	case GLP_MSG_ERR:
 	case GLP_MSG_ON:
@@ -669,9 +1057,9 @@ static PyObject* LPX_solver_integer(LPXObject *self, PyObject *args,
 		break;
 	default:
 		PyErr_SetString(PyExc_ValueError, "invalid value for msg_lev (LPX.MSG_* are valid values)");
-	    	return NULL;
+	    	return 0;
 	}
-	switch (cp.br_tech) {
+	switch (cp->br_tech) {
 	case GLP_BR_FFV:
 	case GLP_BR_LFV:
 	case GLP_BR_MFV:
@@ -680,9 +1068,9 @@ static PyObject* LPX_solver_integer(LPXObject *self, PyObject *args,
 		break;
 	default:
 		PyErr_SetString(PyExc_ValueError, "invalid value for br_tech (LPX.BR_* are valid values)");
-		return NULL;
+		return 0;
 	}
-	switch (cp.bt_tech) {
+	switch (cp->bt_tech) {
 	case GLP_BT_DFS:
 	case GLP_BT_BFS:
 	case GLP_BT_BLB:
@@ -690,59 +1078,106 @@ static PyObject* LPX_solver_integer(LPXObject *self, PyObject *args,
 		break;
 	default:
 		PyErr_SetString(PyExc_ValueError, "invalid value for bt_tech (LPX.BT_* are valid values)");
-		return NULL;
+		return 0;
 	}
-	switch (cp.pp_tech) {
+	switch (cp->pp_tech) {
 	case GLP_PP_NONE:
 	case GLP_PP_ROOT:
 	case GLP_PP_ALL:
 		break;
 	default:
 		PyErr_SetString(PyExc_ValueError, "invalid value for pp_tech (LPX.PP_* are valid values)");
-		return NULL;
+		return 0;
 	}
 
-	if (cp.ps_tm_lim < 0) {
+	if (cp->ps_tm_lim < 0) {
 		PyErr_SetString(PyExc_ValueError, "ps_tm_lim must be nonnegative");
-		return NULL;
+		return 0;
 	}
-	if (cp.tol_int <= 0 || cp.tol_int >= 1) {
+	if (cp->tol_int <= 0 || cp->tol_int >= 1) {
 		PyErr_SetString(PyExc_ValueError, "tol_int must obey 0<tol_int<1");
-		return NULL;
+		return 0;
 	}
-	if (cp.tol_obj <= 0 || cp.tol_obj >= 1) {
+	if (cp->tol_obj <= 0 || cp->tol_obj >= 1) {
 		PyErr_SetString(PyExc_ValueError, "tol_obj must obey 0<tol_obj<1");
-		return NULL;
+		return 0;
 	}
-	if (cp.mip_gap < 0) {
+	if (cp->mip_gap < 0) {
 		PyErr_SetString(PyExc_ValueError, "mip_gap must be non-negative");
-		return NULL;
+		return 0;
 	}
-	if (cp.tm_lim < 0) {
+	if (cp->tm_lim < 0) {
 		PyErr_SetString(PyExc_ValueError, "tm_lim must be non-negative");
-		return NULL;
+		return 0;
 	}
-	if (cp.out_frq <= 0) {
+	if (cp->out_frq <= 0) {
 		PyErr_SetString(PyExc_ValueError, "out_frq must be positive");
-		return NULL;
+		return 0;
 	}
-	if (cp.out_dly<0) {
+	if (cp->out_dly<0) {
 		PyErr_SetString(PyExc_ValueError, "out_dly must be non-negative");
+		return 0;
+	}
+	if (!Search_Check(search))
+		return 0;
+
+	return 1;
+}
+
+static PyObject* LPX_solver_integer(LPXObject *self, PyObject *args,
+		PyObject *keywds)
+{
+	PyObject *callback = NULL, *cancel = NULL;
+	struct mip_callback_object*info = NULL;
+	int nogil = 0;
+	glp_iocp cp;
+	Search search;
+	if (!LPX_ParseIocp(args, keywds, &cp, &callback, &cancel, &nogil,
+			   &search))
+		return NULL;
+	if ((cp.presolve == GLP_OFF) && (glp_get_status(LP) != GLP_OPT)) {
+		PyErr_SetString(PyExc_RuntimeError, "integer solver without presolve requires existing optimal basic solution");
 		return NULL;
 	}
 
-	int retval;
-	if (callback != NULL && callback != Py_None) {
+	int retval, native;
+	if (callback == Py_None)
+		callback = NULL;
+	// A C function is called directly by the solver, without the GIL.
+	if ((native = LPX_MipCallbackCapsule(callback, &cp)) < 0)
+		return NULL;
+	if (native)
+		callback = NULL;
+	if (!LPX_BeginSolve(self))
+		return NULL;
+	if (callback != NULL || cancel != NULL || Search_Active(&search)) {
 		info = (struct mip_callback_object*)
 			malloc(sizeof(struct mip_callback_object));
-		info->callback = callback;
+		if (info == NULL) {
+			self->solving = 0;
+			return PyErr_NoMemory();
+		}
+		if (!LPX_MipCallbackInit(&info->cb, callback)) {
+			self->solving = 0;
+			free(info);
+			return NULL;
+		}
+		info->cb_func = cp.cb_func;
+		info->cb_info = cp.cb_info;
+		info->cancel = cancel;
 		info->py_lp = self;
+		info->search = search;
+		Search_Prepare(&info->search, &cp);
 		cp.cb_info = info;
 		cp.cb_func = mip_callback;
 	}
-	retval = glp_intopt(LP, &cp);
-	if (info)
+	SOLVE(nogil, retval = glp_intopt(LP, &cp));
+	self->solving = 0;
+	if (info) {
+		LPX_MipCallbackClear(&info->cb);
+		Search_Clear(&info->search);
 		free(info);
+	}
 	if (PyErr_Occurred()) {
 		/* This should happen only if there was a problem within the
 		 * callback function, or if the callback was not appropriate.
@@ -751,7 +1186,32 @@ static PyObject* LPX_solver_integer(LPXObject *self, PyObject *args,
 	}
 	if (retval!=GLP_EBADB && retval!=GLP_ESING && retval!=GLP_ECOND && retval!=GLP_EBOUND && retval!=GLP_EFAIL)
 		self->last_solver = 2;
-	return glpsolver_retval_to_message(retval);
+	return Cancel_Message(retval,
+			      retval == GLP_ESTOP && Cancel_Check(cancel));
+}
+
+static PyObject* LPX_solver_simplex_async(LPXObject *self, PyObject *args,
+		PyObject *keywds)
+{
+	return Solve_Async(self, SOLVE_SIMPLEX, args, keywds);
+}
+
+static PyObject* LPX_solver_integer_async(LPXObject *self, PyObject *args,
+		PyObject *keywds)
+{
+	return Solve_Async(self, SOLVE_INTEGER, args, keywds);
+}
+
+static PyObject* LPX_solver_integer_race(LPXObject *self, PyObject *args,
+		PyObject *keywds)
+{
+	return Solve_IntegerRace(self, args, keywds);
+}
+
+static PyObject* LPX_solve_concurrent(LPXObject *self, PyObject *args,
+		PyObject *keywds)
+{
+	return Solve_Concurrent(self, args, keywds);
 }
 
 static PyObject* LPX_solver_intopt(LPXObject *self)
@@ -761,7 +1221,9 @@ static PyObject* LPX_solver_intopt(LPXObject *self)
 
         //TODO: add kwargs for iocp
         glp_init_iocp(&parm);
-	retval = glp_intopt(LP, &parm);
+	if (!LPX_CheckChange(self))
+		return NULL;
+	SOLVE(0, retval = glp_intopt(LP, &parm));
 	if (!retval)
 		self->last_solver = 2;
 	return glpsolver_retval_to_message(retval);
@@ -800,10 +1262,341 @@ static KKTObject* LPX_kktint(LPXObject *self) {
 
 static  PyObject* LPX_warm_up(LPXObject *self) {
 	int retval;
+	if (!LPX_CheckChange(self))
+		return NULL;
 	retval = glp_warm_up(LP);
 	return glpsolver_retval_to_message(retval);
 }
 
+/*
+ * Install the given basis statuses, m for rows and n for columns.  All
+ * codes are checked before anything is changed.  Returns 0 on success,
+ * -1 with an exception set on failure.
+ */
+static int lpx_install_basis(LPXObject *self, const int rstat[],
+			     const int cstat[])
+{
+	int i, m = glp_get_num_rows(LP), n = glp_get_num_cols(LP);
+	for (i = 0; i < m + n; ++i) {
+		int stat = i < m ? rstat[i] : cstat[i-m];
+		if (stat < GLP_BS || stat > GLP_NS) {
+			PyErr_Format(PyExc_ValueError,
+				     "%s status code %d at index %d unrecognized",
+				     i < m ? "row" : "column", stat,
+				     i < m ? i : i-m);
+			return -1;
+		}
+	}
+	for (i = 0; i < m; ++i)
+		glp_set_row_stat(LP, i+1, rstat[i]);
+	for (i = 0; i < n; ++i)
+		glp_set_col_stat(LP, i+1, cstat[i]);
+	return 0;
+}
+
+static PyObject* LPX_get_basis(LPXObject *self)
+{
+	int i, m = glp_get_num_rows(LP), n = glp_get_num_cols(LP);
+	signed char *rstat, *cstat;
+	PyObject *rob, *cob, *retval = NULL;
+
+	rob = util_new_buffer("b", m, (void**)&rstat);
+	cob = util_new_buffer("b", n, (void**)&cstat);
+	if (rob != NULL && cob != NULL) {
+		for (i = 0; i < m; ++i)
+			rstat[i] = glp_get_row_stat(LP, i+1);
+		for (i = 0; i < n; ++i)
+			cstat[i] = glp_get_col_stat(LP, i+1);
+		retval = PyTuple_Pack(2, rob, cob);
+	}
+	Py_XDECREF(rob);
+	Py_XDECREF(cob);
+	return retval;
+}
+
+static PyObject* LPX_set_basis(LPXObject *self, PyObject *args,
+			       PyObject *kwds)
+{
+	static char *kwlist[] = {"row_stat", "col_stat", "warm_up", NULL};
+	PyObject *rob, *cob;
+	Py_buffer rview, cview;
+	int warm = 0, *rstat = NULL, *cstat = NULL, failed = 1;
+
+	if (!LPX_CheckChange(self))
+		return NULL;
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|i", kwlist,
+					 &rob, &cob, &warm))
+		return NULL;
+	if (!util_buffer_get(rob, "row statuses", &rview))
+		return NULL;
+	if (!util_buffer_get(cob, "column statuses", &cview)) {
+		PyBuffer_Release(&rview);
+		return NULL;
+	}
+	if (util_buffer_len(&rview) != glp_get_num_rows(LP) ||
+	    util_buffer_len(&cview) != glp_get_num_cols(LP)) {
+		PyErr_Format(PyExc_ValueError,
+			     "basis must have %d row and %d column statuses",
+			     glp_get_num_rows(LP), glp_get_num_cols(LP));
+	} else if ((rstat = util_buffer_ints(&rview, "row statuses", 0)) &&
+		   (cstat = util_buffer_ints(&cview, "column statuses", 0))) {
+		failed = lpx_install_basis(self, rstat, cstat);
+	}
+	free(rstat);
+	free(cstat);
+	PyBuffer_Release(&rview);
+	PyBuffer_Release(&cview);
+	if (failed)
+		return NULL;
+	if (warm)
+		return glpsolver_retval_to_message(glp_warm_up(LP));
+	Py_RETURN_NONE;
+}
+
+/* The kinds of solution of read_solution() and the like, by last_solver. */
+static const char *lpx_solutions[] = {"simplex", "interior", "integer", NULL};
+
+/* The last_solver value of the named kind of solution, or if name is NULL
+   that of the last solver. -1 with an exception set on failure. */
+static int lpx_solution_kind(LPXObject *self, const char *name)
+{
+	int i;
+	if (name == NULL) {
+		if (self->last_solver <= 2)
+			return self->last_solver;
+		PyErr_SetString(PyExc_RuntimeError, "no solver has been run");
+		return -1;
+	}
+	for (i = 0; lpx_solutions[i]; ++i)
+		if (!strcmp(name, lpx_solutions[i]))
+			return i;
+	PyErr_Format(PyExc_ValueError, "kind '%s' unrecognized (simplex, "
+		     "interior and integer are valid values)", name);
+	return -1;
+}
+
+/* Read or write the kind of solution from or to the file, in GLPK's own
+   format. Returns 0 on failure. */
+static int lpx_solution_file(LPXObject *self, int kind, int write,
+			     const char *fname)
+{
+	switch (kind) {
+	case 1:
+		return !(write ? glp_write_ipt(LP, fname) :
+			 glp_read_ipt(LP, fname));
+	case 2:
+		return !(write ? glp_write_mip(LP, fname) :
+			 glp_read_mip(LP, fname));
+	default:
+		return !(write ? glp_write_sol(LP, fname) :
+			 glp_read_sol(LP, fname));
+	}
+}
+
+static PyObject* LPX_write_solution(LPXObject *self, PyObject *args,
+				    PyObject *kwds)
+{
+	static char *kwlist[] = {"fname", "kind", NULL};
+	const char *fname, *name = NULL;
+	int kind;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|z:write_solution",
+					 kwlist, &fname, &name))
+		return NULL;
+	if ((kind = lpx_solution_kind(self, name)) < 0)
+		return NULL;
+	if (!lpx_solution_file(self, kind, 1, fname)) {
+		PyErr_Format(PyExc_RuntimeError, "writer for '%s' failed to "
+			     "write to '%s'", lpx_solutions[kind], fname);
+		return NULL;
+	}
+	Py_RETURN_NONE;
+}
+
+static PyObject* LPX_read_solution(LPXObject *self, PyObject *args,
+				   PyObject *kwds)
+{
+	static char *kwlist[] = {"fname", "kind", NULL};
+	const char *fname, *name = "simplex";
+	int kind;
+
+	if (!LPX_CheckChange(self))
+		return NULL;
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|s:read_solution",
+					 kwlist, &fname, &name))
+		return NULL;
+	if ((kind = lpx_solution_kind(self, name)) < 0)
+		return NULL;
+	if (!lpx_solution_file(self, kind, 0, fname)) {
+		PyErr_Format(PyExc_RuntimeError, "reader for '%s' failed to "
+			     "read '%s'", lpx_solutions[kind], fname);
+		return NULL;
+	}
+	self->last_solver = kind;
+	Py_RETURN_NONE;
+}
+
+static PyObject* LPX_solution_to_bytes(LPXObject *self, PyObject *args,
+				       PyObject *kwds)
+{
+	static char *kwlist[] = {"kind", NULL};
+	const char *name = NULL;
+	PyObject *retval = NULL;
+	util_memfile f;
+	int kind, ok, term;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|z:solution_to_bytes",
+					 kwlist, &name))
+		return NULL;
+	if ((kind = lpx_solution_kind(self, name)) < 0 ||
+	    !util_memfile_open(&f, NULL, 0))
+		return NULL;
+	// GLPK would report writing to the scratch file.
+	term = glp_term_out(GLP_OFF);
+	ok = lpx_solution_file(self, kind, 1, f.path);
+	glp_term_out(term);
+	if (ok)
+		retval = util_memfile_read(&f);
+	else
+		PyErr_Format(PyExc_RuntimeError, "writer for '%s' failed",
+			     lpx_solutions[kind]);
+	util_memfile_close(&f);
+	return retval;
+}
+
+static PyObject* LPX_solution_from_bytes(LPXObject *self, PyObject *args,
+					 PyObject *kwds)
+{
+	static char *kwlist[] = {"data", "kind", NULL};
+	const char *name = "simplex";
+	Py_buffer view;
+	util_memfile f;
+	int kind, ok, term;
+
+	if (!LPX_CheckChange(self))
+		return NULL;
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|s:solution_from_bytes",
+					 kwlist, &view, &name))
+		return NULL;
+	ok = (kind = lpx_solution_kind(self, name)) >= 0 &&
+		util_memfile_open(&f, view.buf, view.len);
+	PyBuffer_Release(&view);
+	if (!ok)
+		return NULL;
+	term = glp_term_out(GLP_OFF);
+	ok = lpx_solution_file(self, kind, 0, f.path);
+	glp_term_out(term);
+	util_memfile_close(&f);
+	if (!ok) {
+		PyErr_Format(PyExc_RuntimeError, "reader for '%s' failed",
+			     lpx_solutions[kind]);
+		return NULL;
+	}
+	self->last_solver = kind;
+	Py_RETURN_NONE;
+}
+
+/*
+ * The basis file format is the 8 byte magic string below, the number of
+ * rows and columns as 4 byte little endian integers, and then one status
+ * byte per row followed by one per column.
+ */
+static const char basis_magic[8] = {'P','y','G','L','P','K','B','1'};
+
+static void put_uint32(unsigned char *buf, unsigned long v)
+{
+	buf[0] = v & 0xff;
+	buf[1] = (v >> 8) & 0xff;
+	buf[2] = (v >> 16) & 0xff;
+	buf[3] = (v >> 24) & 0xff;
+}
+
+static unsigned long get_uint32(const unsigned char *buf)
+{
+	return buf[0] | (buf[1] << 8) | ((unsigned long)buf[2] << 16) |
+		((unsigned long)buf[3] << 24);
+}
+
+static PyObject* LPX_write_basis(LPXObject *self, PyObject *args)
+{
+	char *fname;
+	unsigned char header[16], stat;
+	int i, m = glp_get_num_rows(LP), n = glp_get_num_cols(LP), ok;
+	FILE *f;
+
+	if (!PyArg_ParseTuple(args, "s", &fname))
+		return NULL;
+	if ((f = fopen(fname, "wb")) == NULL)
+		return PyErr_SetFromErrnoWithFilename(PyExc_IOError, fname);
+	memcpy(header, basis_magic, 8);
+	put_uint32(header + 8, m);
+	put_uint32(header + 12, n);
+	ok = fwrite(header, 1, 16, f) == 16;
+	for (i = 0; ok && i < m + n; ++i) {
+		stat = i < m ? glp_get_row_stat(LP, i+1) :
+			glp_get_col_stat(LP, i-m+1);
+		ok = fputc(stat, f) != EOF;
+	}
+	if (fclose(f) != 0)
+		ok = 0;
+	if (!ok)
+		return PyErr_SetFromErrnoWithFilename(PyExc_IOError, fname);
+	Py_RETURN_NONE;
+}
+
+static PyObject* LPX_read_basis(LPXObject *self, PyObject *args,
+				PyObject *kwds)
+{
+	static char *kwlist[] = {"fname", "warm_up", NULL};
+	char *fname;
+	unsigned char header[16];
+	int i, m = glp_get_num_rows(LP), n = glp_get_num_cols(LP), c;
+	int warm = 0, *stat = NULL, failed = 1;
+	FILE *f;
+
+	if (!LPX_CheckChange(self))
+		return NULL;
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|i", kwlist,
+					 &fname, &warm))
+		return NULL;
+	if ((f = fopen(fname, "rb")) == NULL)
+		return PyErr_SetFromErrnoWithFilename(PyExc_IOError, fname);
+	if (fread(header, 1, 16, f) != 16 ||
+	    memcmp(header, basis_magic, 8) != 0) {
+		PyErr_Format(PyExc_ValueError, "'%s' is not a basis file", fname);
+		goto done;
+	}
+	if (get_uint32(header + 8) != (unsigned long)m ||
+	    get_uint32(header + 12) != (unsigned long)n) {
+		PyErr_Format(PyExc_ValueError, "basis in '%s' is for a %lu-by-%lu "
+			     "problem, not %d-by-%d", fname,
+			     get_uint32(header + 8), get_uint32(header + 12),
+			     m, n);
+		goto done;
+	}
+	if ((stat = (int*)calloc(m + n + 1, sizeof(int))) == NULL) {
+		PyErr_NoMemory();
+		goto done;
+	}
+	for (i = 0; i < m + n; ++i) {
+		if ((c = fgetc(f)) == EOF) {
+			PyErr_Format(PyExc_ValueError, "basis file '%s' is "
+				     "truncated", fname);
+			goto done;
+		}
+		stat[i] = c;
+	}
+	failed = lpx_install_basis(self, stat, stat + m);
+done:
+	free(stat);
+	fclose(f);
+	if (failed)
+		return NULL;
+	if (warm)
+		return glpsolver_retval_to_message(glp_warm_up(LP));
+	Py_RETURN_NONE;
+}
+
 PyObject* convert_and_zip(LPXObject *self, const int len, const int ind[], const double val[]) {
 	PyObject *retval;
 	int m, n;
@@ -1000,6 +1793,144 @@ static PyObject* LPX_dual_rtest(LPXObject *self, PyObject *args) {
 	return PyInt_FromLong((long) piv-1);
 }
 
+static PyObject* LPX_from_bytes(PyTypeObject *type, PyObject *args,
+				PyObject *kwds)
+{
+	static char *kwlist[] = {"data", "format", NULL};
+	const char *name = "mps";
+	Py_buffer view;
+	util_memfile f;
+	LPXObject *lpx;
+	int format, ok, term;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|s:from_bytes", kwlist,
+					 &view, &name))
+		return NULL;
+	ok = (format = lpx_format(name)) >= 0 &&
+		util_memfile_open(&f, view.buf, view.len);
+	PyBuffer_Release(&view);
+	if (!ok)
+		return NULL;
+	lpx = (LPXObject*)PyObject_CallObject((PyObject*)type, NULL);
+	if (lpx != NULL) {
+		// GLPK would report reading the scratch file.
+		term = glp_term_out(GLP_OFF);
+		ok = lpx_read_format(lpx->lp, format, f.path);
+		glp_term_out(term);
+		if (!ok)
+			Py_CLEAR(lpx);
+	}
+	util_memfile_close(&f);
+	return (PyObject*)lpx;
+}
+
+static PyObject* LPX_to_bytes(LPXObject *self, PyObject *args,
+			      PyObject *kwds)
+{
+	static char *kwlist[] = {"format", NULL};
+	const char *name = "mps";
+	PyObject *retval = NULL;
+	util_memfile f;
+	int format, ok, term;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|s:to_bytes", kwlist,
+					 &name))
+		return NULL;
+	if ((format = lpx_format(name)) < 0 || !util_memfile_open(&f, NULL, 0))
+		return NULL;
+	term = glp_term_out(GLP_OFF);
+	ok = lpx_write_format(LP, format, f.path);
+	glp_term_out(term);
+	if (ok)
+		retval = util_memfile_read(&f);
+	else
+		PyErr_Format(PyExc_RuntimeError, "writer for '%s' failed",
+			     name);
+	util_memfile_close(&f);
+	return retval;
+}
+
+static PyObject* LPX_save_snapshot(LPXObject *self, PyObject *args,
+				   PyObject *kwds)
+{
+	return Snapshot_SaveFile(self, args, kwds);
+}
+
+static PyObject* LPX_load_snapshot(PyTypeObject *type, PyObject *args,
+				   PyObject *kwds)
+{
+	return Snapshot_LoadFile(type, args, kwds);
+}
+
+static PyObject* LPX_to_shared_memory(LPXObject *self, PyObject *args,
+				      PyObject *kwds)
+{
+	return Snapshot_ToSharedMemory(self, args, kwds);
+}
+
+static PyObject* LPX_from_shared_memory(PyTypeObject *type, PyObject *args,
+					PyObject *kwds)
+{
+	return Snapshot_FromSharedMemory(type, args, kwds);
+}
+
+static PyObject* LPX_solution_to_shared_memory(LPXObject *self,
+					       PyObject *noargs)
+{
+	return Snapshot_SolutionToSharedMemory(self, noargs);
+}
+
+static PyObject* LPX_solution_from_shared_memory(LPXObject *self,
+						 PyObject *args)
+{
+	return Snapshot_SolutionFromSharedMemory(self, args);
+}
+
+static PyObject* LPX_reduce_ex(LPXObject *self, PyObject *args)
+{
+	PyObject *state;
+	int protocol = 0;
+
+	if (!PyArg_ParseTuple(args, "|i:__reduce_ex__", &protocol))
+		return NULL;
+	if ((state = Snapshot_ToBytes(self, SNAPSHOT_ALL)) == NULL)
+		return NULL;
+#if PY_VERSION_HEX >= 0x03080000
+	// Let protocol 5 pickle the snapshot out-of-band, without a copy.
+	if (protocol >= 5)
+		Py_SETREF(state, PyPickleBuffer_FromObject(state));
+	if (state == NULL)
+		return NULL;
+#endif
+	return Py_BuildValue("O()N", (PyObject*)Py_TYPE(self), state);
+}
+
+static PyObject* LPX_reduce(LPXObject *self, PyObject *noargs)
+{
+	PyObject *args = Py_BuildValue("(i)", 2), *retval;
+	if (args == NULL)
+		return NULL;
+	retval = LPX_reduce_ex(self, args);
+	Py_DECREF(args);
+	return retval;
+}
+
+static PyObject* LPX_setstate(LPXObject *self, PyObject *args)
+{
+	Py_buffer view;
+	int ok;
+
+	if (!LPX_CheckChange(self))
+		return NULL;
+	if (!PyArg_ParseTuple(args, "y*:__setstate__", &view))
+		return NULL;
+	ok = Snapshot_Load(self, view.buf, view.len);
+	PyBuffer_Release(&view);
+	if (!ok)
+		return NULL;
+	Py_RETURN_NONE;
+}
+
 static PyObject* LPX_write(LPXObject *self, PyObject *args, PyObject *keywds)
 {
 	static char* kwlist[] = {"mps", "freemps", "cpxlp", "glp", "sol", "sens_bnds",
@@ -1062,8 +1993,11 @@ static PyObject* LPX_write(LPXObject *self, PyObject *args, PyObject *keywds)
 
 	fname = fnames[5];
 	if (fname != NULL) {
-		if (glp_get_status(LP) == GLP_OPT && !glp_bf_exists(LP))
+		if (glp_get_status(LP) == GLP_OPT && !glp_bf_exists(LP)) {
+			if (!LPX_CheckChange(self))
+				return NULL;
 			glp_factorize(LP);
+		}
 		rv = glp_print_ranges(LP, 0, NULL, 0, fname);
 		if (rv != 0) {
 			PyErr_Format(PyExc_RuntimeError, err_msg, kwlist[5], fname);
@@ -1104,6 +2038,8 @@ static PyObject* LPX_getname(LPXObject *self, void *closure)
 static int LPX_setname(LPXObject *self, PyObject *value, void *closure)
 {
 	char *name;
+	if (!LPX_CheckChange(self))
+		return -1;
 	if (value == NULL || value == Py_None) {
 		glp_set_prob_name(LP, NULL);
 		return 0;
@@ -1273,6 +2209,16 @@ int LPX_InitType(PyObject *module)
 	SETCONST(SF_2N);
 	SETCONST(SF_SKIP);
 	SETCONST(SF_AUTO);
+	// These are used in the get_basis and set_basis methods.
+	SETCONST(BS);
+	SETCONST(NL);
+	SETCONST(NU);
+	SETCONST(NF);
+	SETCONST(NS);
+	// These are used in the BarCollection.set_kinds method.
+	SETCONST(CV);
+	SETCONST(IV);
+	SETCONST(BV);
 	// These are used in control parameters for solvers.
 	SETCONST(MSG_OFF);
 	SETCONST(MSG_ERR);
@@ -1304,6 +2250,14 @@ int LPX_InitType(PyObject *module)
 	SETCONST(PP_ROOT);
 	SETCONST(PP_ALL);
 #undef SETCONST
+	// The node selection and strong branching techniques are native.
+	PyDict_SetIntString(LPXType.tp_dict, "SEL_BT", SEARCH_SEL_BT);
+	PyDict_SetIntString(LPXType.tp_dict, "SEL_BEP", SEARCH_SEL_BEP);
+	PyDict_SetIntString(LPXType.tp_dict, "SEL_DFP", SEARCH_SEL_DFP);
+	PyDict_SetIntString(LPXType.tp_dict, "SEL_HYB", SEARCH_SEL_HYB);
+	PyDict_SetIntString(LPXType.tp_dict, "SB_OFF", SEARCH_SB_OFF);
+	PyDict_SetIntString(LPXType.tp_dict, "SB_FULL", SEARCH_SB_FULL);
+	PyDict_SetIntString(LPXType.tp_dict, "SB_REL", SEARCH_SB_REL);
 	// Add in the calls to the other objects.
 	if ((retval = Obj_InitType(module)) != 0)
 		return retval;
@@ -1437,6 +2391,35 @@ static PyGetSetDef LPX_getset[] = {
 	{NULL}
 };
 
+PyDoc_STRVAR(load_matrix_doc,
+"load_matrix(rows, cols, values)\n"
+"\n"
+"Replace the constraint matrix with the entries given in coordinate form.\n"
+"The three arguments are one dimensional objects supporting the buffer\n"
+"protocol, e.g., array.array or NumPy arrays, of equal length; entry k of\n"
+"the matrix is at row rows[k] and column cols[k] (both 0-based) with value\n"
+"values[k]. Indices may be any integer type, values any integer or float\n"
+"type. This is equivalent to assigning a list of (row, col, value) triples\n"
+"to the matrix attribute, but avoids building Python objects for each\n"
+"entry. Zero values are not stored. Raises IndexError if an index is out\n"
+"of range, or ValueError if the same position is given twice.");
+
+PyDoc_STRVAR(matrix_csr_doc,
+"matrix_csr() -> (indptr, indices, data)\n"
+"\n"
+"Return the constraint matrix in compressed sparse row form. The nonzero\n"
+"entries of row i are at column indices[k] with value data[k], for k in\n"
+"range(indptr[i], indptr[i+1]); column indices within each row are\n"
+"ascending. The three items are memoryviews of a contiguous buffer, of\n"
+"format 'i' for indptr and indices and 'd' for data, so they may be\n"
+"handed to array.array or numpy.frombuffer without copying.");
+
+PyDoc_STRVAR(matrix_csc_doc,
+"matrix_csc() -> (indptr, indices, data)\n"
+"\n"
+"Return the constraint matrix in compressed sparse column form. This is\n"
+"the same as matrix_csr(), with the roles of rows and columns swapped.");
+
 PyDoc_STRVAR(erase_doc,
 "erase()\n"
 "\n"
@@ -1580,6 +2563,16 @@ PyDoc_STRVAR(simplex_doc,
 "presolve\n"
 "  Use the LP presolver. (default False)\n"
 "\n"
+"nogil\n"
+"  Release the Python global interpreter lock while the solver runs, so that\n"
+"  other Python threads may run in parallel. See the note on threads in the\n"
+"  LPX class documentation. (default False)\n"
+"\n"
+"cancel\n"
+"  A CancelToken which stops the solver once cancelled. The solver then\n"
+"  runs without the presolver in slices of iterations, checking the token\n"
+"  between them, and returns 'cancelled' if stopped. (default None)\n"
+"\n"
 "This returns None if the problem was successfully solved. Alternately, on\n"
 "failure it will return one of the following strings to indicate failure\n"
 "type.\n"
@@ -1601,12 +2594,16 @@ PyDoc_STRVAR(simplex_doc,
 "  No primal feasible solution. (Presolver only.)\n"
 "nodfs\n"
 "  No dual feasible solution. (Presolver only.)\n"
+"cancelled\n"
+"  The cancel token was cancelled.\n"
 );
 
 PyDoc_STRVAR(exact_doc,
-"exact()\n"
+"exact([nogil=False, cancel=None])\n"
 "\n"
-"Attempt to solve the problem using an exact simplex method.\n"
+"Attempt to solve the problem using an exact simplex method. If nogil is\n"
+"true, the Python global interpreter lock is released while solving. The\n"
+"cancel token is handled as by the simplex method.\n"
 "\n"
 "This returns None if the problem was successfully solved. Alternately, on\n"
 "failure it will return one of the following strings to indicate failure\n"
@@ -1618,13 +2615,18 @@ PyDoc_STRVAR(exact_doc,
 "itlim\n"
 "  Iteration limited exceeded.\n"
 "tmlim\n"
-"  Time limit exceeded."
+"  Time limit exceeded.\n"
+"cancelled\n"
+"  The cancel token was cancelled."
 );
 
 PyDoc_STRVAR(interior_doc,
-"interior()\n"
+"interior([nogil=False, cancel=None])\n"
 "\n"
-"Attempt to solve the problem using an interior-point method.\n"
+"Attempt to solve the problem using an interior-point method. If nogil is\n"
+"true, the Python global interpreter lock is released while solving. The\n"
+"interior-point solver cannot be interrupted, so a CancelToken given as\n"
+"cancel is only checked before it starts.\n"
 "\n"
 "This returns None if the problem was successfully solved. Alternately, on\n"
 "failure it will return one of the following strings to indicate failure\n"
@@ -1639,7 +2641,9 @@ PyDoc_STRVAR(interior_doc,
 "itlim\n"
 "  Iteration limited exceeded.\n"
 "instab\n"
-"  Numerical instability when solving Newtonian system."
+"  Numerical instability when solving Newtonian system.\n"
+"cancelled\n"
+"  The cancel token was cancelled."
 );
 
 PyDoc_STRVAR(integer_doc,
@@ -1751,12 +2755,73 @@ PyDoc_STRVAR(integer_doc,
 "binarize\n"
 "  Binarization option, used only if presolver is enabled (default False)\n"
 "\n"
+"nogil\n"
+"  Release the Python global interpreter lock while the solver runs. It is\n"
+"  reacquired whenever the callback object is invoked. (default False)\n"
+"\n"
 "callback\n"
 "  A callback object the user may use to monitor and control the solver.\n"
 "  During certain portions of the optimization, the solver will call methods\n"
 "  of callback object. (default None)\n"
 "\n"
-"The last parameter, callback, is worth its own discussion. During the \n"
+"cancel\n"
+"  A CancelToken which terminates the search once cancelled, checked\n"
+"  whenever the solver would invoke the callback. The method then returns\n"
+"  'cancelled'. (default None)\n"
+"\n"
+"sel_tech\n"
+"  Node selection technique option. Other than LPX.SEL_BT, these are run\n"
+"  natively from the solver's callback, whenever it backtracks, with no\n"
+"  Python frame.\n"
+"\n"
+"  LPX.SEL_BT\n"
+"    as chosen by bt_tech (default)\n"
+"  LPX.SEL_BEP\n"
+"    best estimate by pseudocosts\n"
+"  LPX.SEL_DFP\n"
+"    depth first, plunging to the best local bound every sel_frq\n"
+"    selections\n"
+"  LPX.SEL_HYB\n"
+"    depth first until a solution is found, then best estimate until the\n"
+"    gap is at most sel_gap, then best local bound\n"
+"\n"
+"  LPX.SEL_BEP and LPX.SEL_HYB learn the pseudocosts, the changes of the\n"
+"  objective per unit change of a column, by branching themselves, in\n"
+"  place of br_tech, upon the column with the best product of estimated\n"
+"  changes.\n"
+"\n"
+"sel_frq\n"
+"  How often LPX.SEL_DFP selects the best local bound. (default 10)\n"
+"\n"
+"sel_gap\n"
+"  The relative gap below which LPX.SEL_HYB selects the best local\n"
+"  bound. (default 0.1)\n"
+"\n"
+"sb_tech\n"
+"  Strong branching technique option. Other than LPX.SB_OFF, these branch\n"
+"  natively in place of br_tech, upon the column with the best product of\n"
+"  the objective changes of its branches, estimated by solving them with\n"
+"  at most sb_it_lim dual simplex iterations, or by the pseudocosts.\n"
+"\n"
+"  LPX.SB_OFF\n"
+"    no strong branching (default)\n"
+"  LPX.SB_FULL\n"
+"    evaluate the sb_cand columns with the best pseudocosts\n"
+"  LPX.SB_REL\n"
+"    reliability branching, evaluating at most sb_cand columns until\n"
+"    their pseudocosts have sb_rel observations in each direction\n"
+"\n"
+"sb_cand\n"
+"  How many columns are evaluated at most per node. (default 10)\n"
+"\n"
+"sb_it_lim\n"
+"  Dual simplex iteration limit per evaluated branch. (default 50)\n"
+"\n"
+"sb_rel\n"
+"  Observations making the pseudocosts of a column reliable for\n"
+"  LPX.SB_REL. (default 4)\n"
+"\n"
+"The callback parameter is worth its own discussion. During the \n"
 "branch-and-cut algorithm of the MIP solver, at various points callback\n"
 "hooks are invoked which allow the user code to influence the proceeding of\n"
 "the MIP solver. The user code may influence the solver in the hook by\n"
@@ -1795,6 +2860,24 @@ PyDoc_STRVAR(integer_doc,
 "neither the named hook method nor the default method exist, then the hook\n"
 "is ignored.\n"
 "\n"
+"The callback may instead be a PyCapsule named\n"
+"'void (glp_tree *, void *)' wrapping a pointer to a C function of that\n"
+"signature, e.g., a Cython, cffi or numba cfunc. The solver calls it\n"
+"directly with the glp_tree and the capsule's context, if any, as the\n"
+"info argument, for every reason, with no Python frame. It is called\n"
+"without the GIL if nogil is set, and from the solving thread in the\n"
+"threaded solvers, so it must take the GIL itself to use Python.\n"
+"\n"
+"With a native sel_tech or sb_tech, the callback is invoked first, and the\n"
+"native technique selects a node or branches only if a callback method did\n"
+"not.\n"
+"A C callback must leave those to the technique.\n"
+"\n"
+"The methods are looked up once, when the solver starts, so methods added\n"
+"to or replaced upon the callback object during the solve are not seen,\n"
+"and hooks without a method cost nothing. The same Tree instance is passed\n"
+"to every call of one solve, and is only valid during a call.\n"
+"\n"
 "This method requires a mixed-integer problem where an optimal solution to\n"
 "an LP relaxation (either through simplex() or exact()) has already been\n"
 "found. Alternately, try intopt().\n"
@@ -1815,7 +2898,93 @@ PyDoc_STRVAR(integer_doc,
 "tmlim\n"
 "  Time limit exceeded.\n"
 "sing\n"
-"  Error occurred solving an LP relaxation subproblem."
+"  Error occurred solving an LP relaxation subproblem.\n"
+"cancelled\n"
+"  The cancel token was cancelled."
+);
+
+PyDoc_STRVAR(simplex_async_doc,
+"simplex_async([keyword arguments])\n"
+"\n"
+"Start solving the problem with simplex() on a native thread, and return an\n"
+"asyncio future of the running event loop, which receives what simplex()\n"
+"would have returned once the solver is done. This must be called with an\n"
+"event loop running in this thread, e.g., from a coroutine, which may then\n"
+"await the result while the loop serves other tasks:\n"
+"\n"
+"  retval = await lp.simplex_async(msg_lev=LPX.MSG_OFF)\n"
+"\n"
+"The keyword arguments are those of simplex(). The solver works upon a\n"
+"copy of the problem, which is copied back over the problem upon the\n"
+"loop's thread before the future is resolved, so the solution is exact.\n"
+"The problem must not be modified meanwhile, and the loop must keep\n"
+"running until then. Cancelling the future stops the solver as a\n"
+"cancelled CancelToken would, so the solver always runs in slices without\n"
+"the presolver. This requires GLPK built with thread local storage, as it\n"
+"is by default."
+);
+
+PyDoc_STRVAR(integer_async_doc,
+"integer_async([keyword arguments])\n"
+"\n"
+"Start solving the problem with integer() on a native thread, and return an\n"
+"asyncio future of the running event loop, in the same way as\n"
+"simplex_async(). The keyword arguments are those of integer().\n"
+"\n"
+"The methods of a callback object are run upon the event loop's thread,\n"
+"with the solver waiting for each to return, and an exception raised by\n"
+"one is set upon the future. Their tree's lp attribute is the solver's\n"
+"copy of the problem rather than this LPX instance, and is only valid\n"
+"during the call. It may be read, but changing it, or adding or deleting\n"
+"cuts, raises RuntimeError, as its memory belongs to the solver's thread.\n"
+"Cancelling the future terminates the search at the next opportunity."
+);
+
+PyDoc_STRVAR(integer_race_doc,
+"integer_race(configurations, [keyword arguments])\n"
+"\n"
+"Race several configurations of the integer solver against each other,\n"
+"each upon its own native thread, and keep the solution of the first to\n"
+"finish successfully, or of the last to finish if none does. The\n"
+"configurations are a sequence of dicts of keyword arguments of\n"
+"integer(), such as br_tech, bt_tech, pp_tech, the cuts or cancel, which\n"
+"override the keyword arguments given here for all of them, e.g.:\n"
+"\n"
+"  lp.integer_race([{'br_tech': LPX.BR_MFV}, {'bt_tech': LPX.BT_BPH,\n"
+"                   'gmi_cuts': True}], presolve=True)\n"
+"\n"
+"Once one has finished, the others are terminated at their next\n"
+"opportunity. This returns a tuple of what integer() would have returned\n"
+"for the winner, and the winner's index among the configurations. Each\n"
+"configuration solves a private copy of the problem, and only the\n"
+"winner's solved copy is copied back over this problem, so its MIP\n"
+"solution is exact. Only C callbacks in a PyCapsule are\n"
+"supported. This requires GLPK built with thread local storage, as it is\n"
+"by default."
+);
+
+PyDoc_STRVAR(solve_concurrent_doc,
+"solve_concurrent(methods=('primal', 'dual'), [keyword args])\n"
+"\n"
+"Race several LP methods against each other, each upon its own native\n"
+"thread, and keep the solution of the first to finish successfully, or of\n"
+"the last to finish if none does. The methods are 'primal', 'dual' and\n"
+"'dualp', which run simplex() with the corresponding meth, and\n"
+"'interior', which runs interior(). The keyword arguments are those of\n"
+"simplex(), and apply to every simplex method.\n"
+"\n"
+"This returns a tuple of what the winner's solver method would have\n"
+"returned, and the winner's name. The winner's solution, including its\n"
+"basis for a simplex method, is installed in this problem exactly, as its\n"
+"solved copy is copied back over it. Each method solves a private copy\n"
+"of the problem.\n"
+"The simplex methods run in slices without the presolver, as with a\n"
+"CancelToken, so that the losers stop shortly after the winner finishes,\n"
+"but the interior-point method cannot be interrupted, and if it loses\n"
+"this still waits for it to finish before returning, as no thread is\n"
+"left running afterwards. So it is not raced by default. A cancel token\n"
+"stops all of them. This requires GLPK built with thread local storage,\n"
+"as it is by default."
 );
 
 PyDoc_STRVAR(intopt_doc,
@@ -1902,6 +3071,159 @@ PyDoc_STRVAR(write_doc,
 "  MIP solution in printable format."
 );
 
+PyDoc_STRVAR(from_bytes_doc,
+"from_bytes(data, format='mps')\n"
+"\n"
+"Return a new LPX holding the problem data in data, any bytes-like object\n"
+"such as bytes, bytearray, memoryview or mmap, in the given format, one of\n"
+"those of LPX() and write(): 'mps', 'freemps', 'cpxlp' or 'glp'. GLPK's\n"
+"readers only take file names, so the data is copied once into an\n"
+"anonymous in-memory file where the platform provides one (Linux), else\n"
+"into a temporary file, and read from there without terminal output."
+);
+
+PyDoc_STRVAR(to_bytes_doc,
+"to_bytes(format='mps')\n"
+"\n"
+"Return the problem data in the given format, as for from_bytes(), as a\n"
+"bytes object, written by GLPK's writer in the same way."
+);
+
+PyDoc_STRVAR(to_shared_memory_doc,
+"to_shared_memory(names=True, basis=True, solution=True)\n"
+"\n"
+"Write a snapshot of the problem, as save_snapshot() would, straight into\n"
+"a new multiprocessing.shared_memory.SharedMemory segment, and return it.\n"
+"The segment, or its name, may be handed to other processes, e.g., through\n"
+"a process pool, which build the problem from it with from_shared_memory()\n"
+"without any copy through pipes. The caller owns the segment, and must\n"
+"close() and unlink() it once the other processes are done with it."
+);
+
+PyDoc_STRVAR(from_shared_memory_doc,
+"from_shared_memory(handle)\n"
+"\n"
+"Return a new LPX holding the problem in the shared memory segment made by\n"
+"to_shared_memory(), given as the SharedMemory or its name. A segment\n"
+"attached by name is closed again once the problem is built."
+);
+
+PyDoc_STRVAR(solution_to_shared_memory_doc,
+"solution_to_shared_memory()\n"
+"\n"
+"Write the solution of the last solver, as arrays of its statuses and\n"
+"values laid out like a snapshot's, into a new SharedMemory segment, and\n"
+"return it, as to_shared_memory() does for the problem. The values are\n"
+"read back exactly. Typically a worker returns a solution in this way to\n"
+"the process that holds the problem it solved, which then reads it with\n"
+"solution_from_shared_memory()."
+);
+
+PyDoc_STRVAR(solution_from_shared_memory_doc,
+"solution_from_shared_memory(handle)\n"
+"\n"
+"Read a solution from the segment made by solution_to_shared_memory(),\n"
+"given as the SharedMemory or its name, into this problem, which must have\n"
+"the same rows and columns as the problem it was solved upon. The problem\n"
+"then reports that solution as that of the solver which found it."
+);
+
+PyDoc_STRVAR(reduce_doc,
+"Pickle support: an LPX pickles as a snapshot, as save_snapshot() would\n"
+"write with all its sections, which under pickle protocol 5 is handed over\n"
+"as an out-of-band buffer."
+);
+
+PyDoc_STRVAR(setstate_doc,
+"__setstate__(state)\n"
+"\n"
+"Load the snapshot pickled as state into this empty problem."
+);
+
+PyDoc_STRVAR(save_snapshot_doc,
+"save_snapshot(path, names=True, basis=True, solution=True)\n"
+"\n"
+"Save the problem to a binary snapshot file, which load_snapshot() reads\n"
+"back far faster than any of the text formats, as it holds the problem's\n"
+"arrays as GLPK takes them, in this machine's byte order. Besides the\n"
+"objective, bounds, column kinds and constraint matrix, it holds, unless\n"
+"the corresponding argument is false, the names, the basis statuses and\n"
+"the solution of the last solver, if any. All values, the solution's\n"
+"included, are kept exactly."
+);
+
+PyDoc_STRVAR(load_snapshot_doc,
+"load_snapshot(path)\n"
+"\n"
+"Return a new LPX holding the problem in a snapshot file written by\n"
+"save_snapshot(). The file is mapped into memory and its arrays handed to\n"
+"GLPK without parsing, once checked. A ValueError is raised for a file\n"
+"that is not a snapshot, or was written in another byte order or by an\n"
+"incompatible version."
+);
+
+PyDoc_STRVAR(get_basis_doc,
+"get_basis() -> (row_stat, col_stat)\n"
+"\n"
+"Return the statuses of all rows and columns in the current basis as two\n"
+"memoryviews of signed bytes ('b' format), in index order. Each entry is\n"
+"one of LPX.BS (basic), LPX.NL (non-basic on lower bound), LPX.NU\n"
+"(non-basic on upper bound), LPX.NF (non-basic free) or LPX.NS (non-basic\n"
+"fixed). These may be stored and later handed to set_basis() to\n"
+"warm-start another solve of the same problem.");
+
+PyDoc_STRVAR(set_basis_doc,
+"set_basis(row_stat, col_stat[, warm_up=False])\n"
+"\n"
+"Install a basis, as returned by get_basis(). The arguments are buffer\n"
+"protocol objects holding one integer status code per row and column\n"
+"respectively. Nothing is changed if a code is invalid. If warm_up is\n"
+"true, the basis is then factorized and its solution computed as with\n"
+"warm_up(), and the result of that is returned; otherwise returns None.");
+
+PyDoc_STRVAR(write_basis_doc,
+"write_basis(fname)\n"
+"\n"
+"Write the current basis to a file in a compact binary format, one byte\n"
+"per row and column plus a 16 byte header, for later use with\n"
+"read_basis().");
+
+PyDoc_STRVAR(read_basis_doc,
+"read_basis(fname[, warm_up=False])\n"
+"\n"
+"Read a basis written by write_basis() and install it as with\n"
+"set_basis(). The file must have been written from a problem with the\n"
+"same number of rows and columns.");
+
+PyDoc_STRVAR(write_solution_doc,
+"write_solution(fname, kind=None)\n"
+"\n"
+"Write a solution to a file in GLPK's own machine-readable format, for\n"
+"later use with read_solution(), unlike the reports of write(). The kind\n"
+"of solution is 'simplex' for the basic solution of simplex() or exact(),\n"
+"'interior' for that of interior(), or 'integer' for that of integer() or\n"
+"intopt(), and by default that of the last solver.");
+
+PyDoc_STRVAR(read_solution_doc,
+"read_solution(fname, kind='simplex')\n"
+"\n"
+"Read the kind of solution, as for write_solution(), from a file it wrote\n"
+"from a problem with the same rows and columns, and make it the problem's\n"
+"solution, as though that solver had just found it. Its values have the\n"
+"15 significant digits of GLPK's format.");
+
+PyDoc_STRVAR(solution_to_bytes_doc,
+"solution_to_bytes(kind=None)\n"
+"\n"
+"Return the kind of solution, as for write_solution(), in the same format\n"
+"as a bytes object.");
+
+PyDoc_STRVAR(solution_from_bytes_doc,
+"solution_from_bytes(data, kind='simplex')\n"
+"\n"
+"Read the kind of solution from data, any bytes-like object, as written\n"
+"by solution_to_bytes() or write_solution(), as read_solution() does.");
+
 PyDoc_STRVAR(warm_up__doc__,
 "LPX.warm_up() -> string\n\n"
 "Warms up the LP basis.\n"
@@ -1981,6 +3303,10 @@ PyDoc_STRVAR(dual_ratio_test__doc__,
 );
 
 static PyMethodDef LPX_methods[] = {
+	{"load_matrix", (PyCFunction)LPX_LoadMatrix, METH_VARARGS,
+	load_matrix_doc},
+	{"matrix_csr", (PyCFunction)LPX_MatrixCSR, METH_NOARGS, matrix_csr_doc},
+	{"matrix_csc", (PyCFunction)LPX_MatrixCSC, METH_NOARGS, matrix_csc_doc},
 	{"erase", (PyCFunction)LPX_Erase, METH_NOARGS, erase_doc},
 	{"copy", (PyCFunction)LPX_Copy, METH_VARARGS, copy_doc},
 	{"scale", (PyCFunction)LPX_Scale, METH_VARARGS, scale_doc},
@@ -1992,16 +3318,64 @@ static PyMethodDef LPX_methods[] = {
 	// Solver routines.
 	{"simplex", (PyCFunction)LPX_solver_simplex, METH_VARARGS|METH_KEYWORDS,
 	simplex_doc},
-	{"exact", (PyCFunction)LPX_solver_exact, METH_NOARGS, exact_doc},
-	{"interior", (PyCFunction)LPX_solver_interior, METH_NOARGS, interior_doc},
+	{"exact", (PyCFunction)LPX_solver_exact, METH_VARARGS|METH_KEYWORDS,
+	exact_doc},
+	{"interior", (PyCFunction)LPX_solver_interior, METH_VARARGS|METH_KEYWORDS,
+	interior_doc},
 	{"integer", (PyCFunction)LPX_solver_integer, METH_VARARGS|METH_KEYWORDS,
 	integer_doc},
+	{"simplex_async", (PyCFunction)LPX_solver_simplex_async,
+	METH_VARARGS|METH_KEYWORDS, simplex_async_doc},
+	{"integer_async", (PyCFunction)LPX_solver_integer_async,
+	METH_VARARGS|METH_KEYWORDS, integer_async_doc},
+	{"integer_race", (PyCFunction)LPX_solver_integer_race,
+	METH_VARARGS|METH_KEYWORDS, integer_race_doc},
+	{"solve_concurrent", (PyCFunction)LPX_solve_concurrent,
+	METH_VARARGS|METH_KEYWORDS, solve_concurrent_doc},
 	{"intopt", (PyCFunction)LPX_solver_intopt, METH_NOARGS, intopt_doc},
 	{"kkt", (PyCFunction)LPX_kkt, METH_VARARGS, kkt_doc},
 	{"kktint", (PyCFunction)LPX_kktint, METH_NOARGS, kktint_doc},
 	// Data writing
 	{"write", (PyCFunction)LPX_write, METH_VARARGS | METH_KEYWORDS, write_doc},
+	{"from_bytes", (PyCFunction)LPX_from_bytes,
+	METH_VARARGS|METH_KEYWORDS|METH_CLASS, from_bytes_doc},
+	{"to_bytes", (PyCFunction)LPX_to_bytes, METH_VARARGS|METH_KEYWORDS,
+	to_bytes_doc},
+	{"to_shared_memory", (PyCFunction)LPX_to_shared_memory,
+	METH_VARARGS|METH_KEYWORDS, to_shared_memory_doc},
+	{"from_shared_memory", (PyCFunction)LPX_from_shared_memory,
+	METH_VARARGS|METH_KEYWORDS|METH_CLASS, from_shared_memory_doc},
+	{"solution_to_shared_memory",
+	(PyCFunction)LPX_solution_to_shared_memory, METH_NOARGS,
+	solution_to_shared_memory_doc},
+	{"solution_from_shared_memory",
+	(PyCFunction)LPX_solution_from_shared_memory, METH_VARARGS,
+	solution_from_shared_memory_doc},
+	{"__reduce__", (PyCFunction)LPX_reduce, METH_NOARGS, reduce_doc},
+	{"__reduce_ex__", (PyCFunction)LPX_reduce_ex, METH_VARARGS,
+	reduce_doc},
+	{"__setstate__", (PyCFunction)LPX_setstate, METH_VARARGS,
+	setstate_doc},
+	{"save_snapshot", (PyCFunction)LPX_save_snapshot,
+	METH_VARARGS|METH_KEYWORDS, save_snapshot_doc},
+	{"load_snapshot", (PyCFunction)LPX_load_snapshot,
+	METH_VARARGS|METH_KEYWORDS|METH_CLASS, load_snapshot_doc},
 	{"warm_up", (PyCFunction)LPX_warm_up, METH_NOARGS, warm_up__doc__},
+	{"get_basis", (PyCFunction)LPX_get_basis, METH_NOARGS, get_basis_doc},
+	{"set_basis", (PyCFunction)LPX_set_basis, METH_VARARGS|METH_KEYWORDS,
+	set_basis_doc},
+	{"write_basis", (PyCFunction)LPX_write_basis, METH_VARARGS,
+	write_basis_doc},
+	{"read_basis", (PyCFunction)LPX_read_basis, METH_VARARGS|METH_KEYWORDS,
+	read_basis_doc},
+	{"write_solution", (PyCFunction)LPX_write_solution,
+	METH_VARARGS|METH_KEYWORDS, write_solution_doc},
+	{"read_solution", (PyCFunction)LPX_read_solution,
+	METH_VARARGS|METH_KEYWORDS, read_solution_doc},
+	{"solution_to_bytes", (PyCFunction)LPX_solution_to_bytes,
+	METH_VARARGS|METH_KEYWORDS, solution_to_bytes_doc},
+	{"solution_from_bytes", (PyCFunction)LPX_solution_from_bytes,
+	METH_VARARGS|METH_KEYWORDS, solution_from_bytes_doc},
 	{"transform_row", (PyCFunction)LPX_transform_row, METH_O, transform_row__doc__},
 	{"transform_col", (PyCFunction)LPX_transform_col, METH_O, transform_col__doc__},
 	{"prime_ratio_test", (PyCFunction)LPX_prim_rtest, METH_VARARGS, prime_ratio_test__doc__},
@@ -2035,6 +3409,13 @@ PyDoc_STRVAR(lpx_doc,
 "obj -> represents the objective function\n"
 "rows -> a collection over which one can access rows\n"
 "cols -> same, but for columns\n"
+"\n"
+"The solver methods accept a nogil keyword which releases the Python global\n"
+"interpreter lock while GLPK runs, so that problems may be solved in\n"
+"parallel from several Python threads. GLPK keeps its environment (memory\n"
+"accounting, terminal output settings and hook) per thread, so a problem\n"
+"should be built and solved within the same thread, and no other thread\n"
+"should use a problem while it is being solved.\n"
 );
 
 PyTypeObject LPXType = {
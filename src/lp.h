@@ -22,6 +22,7 @@ along with PyGLPK.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <Python.h>
 #include <glpk.h>
+#include "search.h"
 
 #define LPX_Check(op) PyObject_TypeCheck(op, &LPXType)
 
@@ -40,6 +41,12 @@ typedef struct {
   // simplex or exact, 1 for interior point, and 2 for integer or
   // intopt.
   unsigned int last_solver:4;
+  // Set while a solver is running on this problem, possibly with the
+  // GIL released, so that no second solve is started upon it.
+  unsigned int solving:1;
+  // Set on the problem an asynchronous solve lends to its callback
+  // upon another thread, where it may be read but not changed.
+  unsigned int foreign:1;
   PyObject *weakreflist; // Weak reference list.
 } LPXObject;
 
@@ -52,4 +59,63 @@ int LPX_InitType(PyObject *module);
 
 PyObject* convert_and_zip(LPXObject*, const int, const int[], const double[]);
 
+/* Marks the problem as being solved. Returns 0 with an exception set if a
+   solver is already running on it, e.g., from another thread while the
+   GIL was released. */
+int LPX_BeginSolve(LPXObject *self);
+/* Returns 0 with an exception set if the problem may not be changed,
+   as when it is lent to the callback of an asynchronous solve. */
+int LPX_CheckChange(LPXObject *self);
+/* Converts a GLPK solver return code to what the solver methods return,
+   None on success and a short string otherwise. */
+PyObject* glpsolver_retval_to_message(int retval);
+/* Parse and check the keyword arguments of LPX.simplex into cp, the
+   CancelToken, if any, as a borrowed reference into cancel, and the nogil
+   argument into nogil. Returns 0 with an exception set on failure, 1 on
+   success. */
+int LPX_ParseSmcp(PyObject *args, PyObject *kwds, glp_smcp *cp,
+		  PyObject **cancel, int *nogil);
+/* As LPX_ParseSmcp, for the arguments of LPX.integer. The callback
+   argument, if given, is stored as a borrowed reference in callback, and
+   the native search parameters in search. */
+int LPX_ParseIocp(PyObject *args, PyObject *kwds, glp_iocp *cp,
+		  PyObject **callback, PyObject **cancel, int *nogil,
+		  Search *search);
+/* The methods of a LPX.integer callback object, resolved once for a
+   solve, and the Tree object handed to them, reused from call to call and
+   only valid during one. */
+#define LPX_MIP_REASONS 8 // Past the largest GLP_I* reason code.
+typedef struct {
+	PyObject *methods[LPX_MIP_REASONS]; // Bound methods, by reason.
+	unsigned int mask; // Bit 1 << reason is set for each method found.
+	PyObject *tree; // The Tree object, made upon the first call.
+	unsigned int wrapped:1; // Whether the tree made its own LPX.
+	// Whether the methods run on another thread than the solver, where
+	// GLPK memory must not be allocated or freed.
+	unsigned int foreign:1;
+} LPXMipCallback;
+/* Whether the callback has a method for the reason. No GIL is needed. */
+#define LPX_MipCallbackHandles(cb, reason) \
+	((unsigned)(reason) < LPX_MIP_REASONS && ((cb)->mask >> (reason) & 1))
+/* Resolve the methods of the callback object, which fall back upon its
+   default method, into cb. Returns 0 with an exception set on failure. */
+int LPX_MipCallbackInit(LPXMipCallback *cb, PyObject *callback);
+/* Calls the method for the tree's current reason, which it must handle,
+   with the Tree object over the tree and problem, with the GIL held. If
+   it fails the search is terminated, leaving the exception set. */
+void LPX_CallMipCallback(LPXMipCallback *cb, glp_tree *tree,
+			 LPXObject *py_lp);
+/* Whether the callback's method for the reason, in its last call, selected
+   a node or branched. No GIL is needed. */
+int LPX_MipCallbackActed(LPXMipCallback *cb, int reason);
+/* Releases the methods and Tree object once the solve is over. */
+void LPX_MipCallbackClear(LPXMipCallback *cb);
+/* The name of a PyCapsule wrapping a C function given as the callback of
+   LPX.integer, whose context, if any, is passed as the function's info. */
+#define LPX_MIP_CAPSULE "void (glp_tree *, void *)"
+/* If the callback is such a PyCapsule, installs its function and context
+   as cp's cb_func and cb_info, and returns 1. Returns 0 if it is not a
+   capsule, and -1 with an exception set if it is not a valid one. */
+int LPX_MipCallbackCapsule(PyObject *callback, glp_iocp *cp);
+
 #endif // _LP_H
@@ -226,6 +226,7 @@ static int Obj_ass_subscript(ObjObject *self,PyObject *item,PyObject *value) {
   double val = 0.0;
   BarColObject *bc = (BarColObject*) (self->py_lp->cols);
 
+  if (!LPX_CheckChange(self->py_lp)) return -1;
   if (value==NULL) {
     PyErr_SetString
       (PyExc_TypeError, "objective function doesn't support item deletion");
@@ -371,6 +372,7 @@ static PyObject* Obj_getname(ObjObject *self, void *closure) {
 }
 static int Obj_setname(ObjObject *self, PyObject *value, void *closure) {
   char *name;
+  if (!LPX_CheckChange(self->py_lp)) return -1;
   if (value==NULL || value==Py_None) {
     glp_set_obj_name(LP, NULL);
     return 0;
@@ -389,6 +391,7 @@ static PyObject* Obj_getmaximize(ObjObject *self, void *closure) {
   return PyBool_FromLong(glp_get_obj_dir(LP)==GLP_MAX);
 }
 static int Obj_setmaximize(ObjObject *self, PyObject *value, void *closure) {
+  if (!LPX_CheckChange(self->py_lp)) return -1;
   int tomax = PyObject_IsTrue(value);
   if (tomax < 0) return -1;
   glp_set_obj_dir(LP, tomax ? GLP_MAX : GLP_MIN);
@@ -400,6 +403,7 @@ static PyObject* Obj_getshift(ObjObject *self, void *closure) {
 }
 static int Obj_setshift(ObjObject *self, PyObject *value, void *closure) {
   double v=0.0;
+  if (!LPX_CheckChange(self->py_lp)) return -1;
   if (extract_double(value, &v)) return -1;
   glp_set_obj_coef(LP, 0, v);
   return 0;
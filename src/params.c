@@ -60,6 +60,7 @@ ParamsObject *Params_New(LPXObject *py_lp) {
 /* Reset all parameters to their defaults. */
 void Params_Reset(ParamsObject *self) { lpx_reset_parms(LP); }
 PyObject *Params_reset(ParamsObject *self) {
+  if (!LPX_CheckChange(self->py_lp)) return NULL;
   Params_Reset(self); Py_RETURN_NONE; }
 
 /****************** GET-SET-ERS ***************/
@@ -95,6 +96,7 @@ static PyObject* Params_parameter_get(ParamsObject *self,
 
 static int Params_parameter_set(ParamsObject *self, PyObject *value,
 				struct param_getsets *pgs) {
+  if (!LPX_CheckChange(self->py_lp)) return -1;
   if (value == NULL) {
     // Maybe in future this should restore to default, but I can't be arsed.
     PyErr_Format(PyExc_TypeError,"cannot delete attribute '%s'",
@@ -0,0 +1,475 @@
+/**************************************************************************
+Copyright (C) 2007, 2008 Thomas Finley, tfinley@gmail.com
+
+This file is part of PyGLPK.
+
+PyGLPK is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+PyGLPK is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with PyGLPK.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#include "2to3.h"
+
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "search.h"
+
+// Selections made other than by a technique of its own.
+#define SEARCH_DEPTH -1 // The deepest, most recently made active node.
+#define SEARCH_BOUND -2 // The best local bound.
+
+/* The data kept with each node, in its glp_ios_node_data. A new node may
+   start out with its parent's data, so it is valid only for the node it
+   names. Objective values are kept as if minimizing. */
+struct search_node {
+	int node; // The subproblem this was filled for.
+	int column; // The column the search branched upon, or 0.
+	unsigned int learned:1; // Whether the parent's branching was learned.
+	unsigned int estimated:1; // Whether estimate was computed.
+	double value; // The column's value in the node's relaxation.
+	double obj; // The relaxation's objective value.
+	double estimate; // The estimated objective of its best solution.
+};
+
+/* A column the node's problem may be branched upon. */
+struct search_cand {
+	int column;
+	unsigned int evaluated:1; // Whether by strong branching.
+	double value; // Its value in the relaxation.
+	double down, up; // Estimated objective changes of each branch.
+	double score;
+};
+
+// Whether the search branches itself, and so keeps pseudocosts.
+#define search_branches(s) ((s)->sel_tech == SEARCH_SEL_BEP || \
+	(s)->sel_tech == SEARCH_SEL_HYB || (s)->sb_tech != SEARCH_SB_OFF)
+
+void Search_Init(Search *s)
+{
+	memset(s, 0, sizeof(*s));
+	s->sel_tech = SEARCH_SEL_BT;
+	s->sel_frq = 10;
+	s->sel_gap = 0.1;
+	s->sb_tech = SEARCH_SB_OFF;
+	s->sb_cand = 10;
+	s->sb_it_lim = 50;
+	s->sb_rel = 4;
+}
+
+int Search_Check(Search *s)
+{
+	switch (s->sel_tech) {
+	case SEARCH_SEL_BT:
+	case SEARCH_SEL_BEP:
+	case SEARCH_SEL_DFP:
+	case SEARCH_SEL_HYB:
+		break;
+	default:
+		PyErr_SetString(PyExc_ValueError, "invalid value for sel_tech (LPX.SEL_* are valid values)");
+		return 0;
+	}
+	if (s->sel_frq <= 0) {
+		PyErr_SetString(PyExc_ValueError, "sel_frq must be positive");
+		return 0;
+	}
+	if (s->sel_gap < 0) {
+		PyErr_SetString(PyExc_ValueError, "sel_gap must be non-negative");
+		return 0;
+	}
+	switch (s->sb_tech) {
+	case SEARCH_SB_OFF:
+	case SEARCH_SB_FULL:
+	case SEARCH_SB_REL:
+		break;
+	default:
+		PyErr_SetString(PyExc_ValueError, "invalid value for sb_tech (LPX.SB_* are valid values)");
+		return 0;
+	}
+	if (s->sb_cand <= 0) {
+		PyErr_SetString(PyExc_ValueError, "sb_cand must be positive");
+		return 0;
+	}
+	if (s->sb_it_lim <= 0) {
+		PyErr_SetString(PyExc_ValueError, "sb_it_lim must be positive");
+		return 0;
+	}
+	if (s->sb_rel < 0) {
+		PyErr_SetString(PyExc_ValueError, "sb_rel must be non-negative");
+		return 0;
+	}
+	return 1;
+}
+
+void Search_Prepare(Search *s, glp_iocp *cp)
+{
+	s->ncols = 0;
+	s->pc_sum = NULL;
+	s->pc_cnt = NULL;
+	s->cands = NULL;
+	s->pc_all[0] = s->pc_all[1] = 0.0;
+	s->pc_all_cnt[0] = s->pc_all_cnt[1] = 0;
+	s->selects = 0;
+	s->failed = 0;
+	if (Search_Active(s))
+		cp->cb_size = sizeof(struct search_node);
+}
+
+void Search_Clear(Search *s)
+{
+	free(s->pc_sum);
+	free(s->pc_cnt);
+	free(s->cands);
+	s->pc_sum = NULL;
+	s->pc_cnt = NULL;
+	s->cands = NULL;
+}
+
+/* The node's data if it was filled for the node, else NULL. */
+static struct search_node *search_valid(glp_tree *tree, int p)
+{
+	struct search_node *d = (struct search_node*)glp_ios_node_data(tree, p);
+	return d != NULL && d->node == p ? d : NULL;
+}
+
+/* The node's data, reset if it was not filled for the node. */
+static struct search_node *search_node(glp_tree *tree, int p)
+{
+	struct search_node *d = (struct search_node*)glp_ios_node_data(tree, p);
+	if (d->node != p) {
+		memset(d, 0, sizeof(*d));
+		d->node = p;
+	}
+	return d;
+}
+
+/* Allocate the pseudocosts upon first use. Without the memory the search
+   goes on, as if nothing was ever observed, and leaves branching to GLPK. */
+static int search_alloc(Search *s, glp_prob *lp)
+{
+	if (s->pc_sum != NULL || s->failed)
+		return s->pc_sum != NULL;
+	s->ncols = glp_get_num_cols(lp);
+	s->pc_sum = (double*)calloc(2 * s->ncols + 1, sizeof(double));
+	s->pc_cnt = (int*)calloc(2 * s->ncols + 1, sizeof(int));
+	s->cands = malloc((s->ncols + 1) * sizeof(struct search_cand));
+	if (s->pc_sum == NULL || s->pc_cnt == NULL || s->cands == NULL) {
+		Search_Clear(s);
+		s->failed = 1;
+	}
+	return !s->failed;
+}
+
+/* The pseudocost of the column in the direction, 0 down and 1 up: the
+   average over its observations, or over every column's if it has none,
+   or 0 if there are none at all. */
+static double search_pc(Search *s, int j, int dir)
+{
+	int k = 2 * (j - 1) + dir;
+	if (s->pc_cnt != NULL && s->pc_cnt[k])
+		return s->pc_sum[k] / s->pc_cnt[k];
+	if (s->pc_all_cnt[dir])
+		return s->pc_all[dir] / s->pc_all_cnt[dir];
+	return 0.0;
+}
+
+/* Record an objective change per unit change of the column. */
+static void search_observe(Search *s, int j, int dir, double unit)
+{
+	int k = 2 * (j - 1) + dir;
+	s->pc_sum[k] += unit;
+	s->pc_cnt[k]++;
+	s->pc_all[dir] += unit;
+	s->pc_all_cnt[dir]++;
+}
+
+/* Once a node's relaxation is solved, observe how the objective changed
+   from its parent's, if the search branched upon the parent. */
+static void search_learn(Search *s, glp_tree *tree, glp_prob *lp, int p,
+			 double sign)
+{
+	struct search_node *d = search_node(tree, p), *pd;
+	int up = glp_ios_up_node(tree, p), j, dir;
+	double f, delta;
+
+	if (d->learned)
+		return;
+	d->learned = 1;
+	if (up == 0 || (pd = search_valid(tree, up)) == NULL ||
+	    pd->column == 0 || !search_alloc(s, lp))
+		return;
+	j = pd->column;
+	f = pd->value - floor(pd->value);
+	// The down branch lowers the column's upper bound below its value.
+	dir = glp_get_col_ub(lp, j) < pd->value ? 0 : 1;
+	delta = sign * glp_get_obj_val(lp) - pd->obj;
+	if (delta < 0)
+		delta = 0;
+	search_observe(s, j, dir, delta / (dir ? 1 - f : f));
+}
+
+static double search_score(double down, double up)
+{
+	return (down > 1e-6 ? down : 1e-6) * (up > 1e-6 ? up : 1e-6);
+}
+
+static int search_cmp_score(const void *a, const void *b)
+{
+	double x = ((const struct search_cand*)a)->score;
+	double y = ((const struct search_cand*)b)->score;
+	return x < y ? 1 : x > y ? -1 : 0;
+}
+
+/* Bound the column of a problem, where -DBL_MAX and DBL_MAX are none. */
+static void search_set_bounds(glp_prob *lp, int j, double lb, double ub)
+{
+	int type;
+	if (lb == -DBL_MAX)
+		type = ub == DBL_MAX ? GLP_FR : GLP_UP;
+	else if (ub == DBL_MAX)
+		type = GLP_LO;
+	else
+		type = lb == ub ? GLP_FX : GLP_DB;
+	glp_set_col_bnds(lp, j, type, lb, ub);
+}
+
+/* Evaluate the candidates by strong branching: solve each branch of a
+   copy of the node's problem with a few dual simplex iterations, from the
+   node's optimal basis, as GLPK's own pseudocost heuristic does. With
+   SEARCH_SB_REL only candidates with unreliable pseudocosts are. Each
+   evaluation is also observed as a pseudocost. */
+static void search_strong(Search *s, glp_prob *lp, double sign,
+			  struct search_cand *cands, int ncands)
+{
+	glp_prob *copy;
+	glp_smcp parm;
+	struct search_cand *c;
+	int i, j, k, m, n, dir, r, evaluated = 0, *stat;
+	double lb, ub, obj = sign * glp_get_obj_val(lp), delta;
+
+	m = glp_get_num_rows(lp);
+	n = glp_get_num_cols(lp);
+	if ((stat = (int*)malloc((m + n + 1) * sizeof(int))) == NULL)
+		return;
+	for (i = 1; i <= m; ++i)
+		stat[i] = glp_get_row_stat(lp, i);
+	for (j = 1; j <= n; ++j)
+		stat[m + j] = glp_get_col_stat(lp, j);
+	copy = glp_create_prob();
+	glp_copy_prob(copy, lp, GLP_OFF);
+	glp_init_smcp(&parm);
+	parm.msg_lev = GLP_MSG_OFF;
+	parm.meth = GLP_DUAL;
+	parm.it_lim = s->sb_it_lim;
+
+	for (k = 0; k < ncands && evaluated < s->sb_cand; ++k) {
+		c = cands + k;
+		j = c->column;
+		if (s->sb_tech == SEARCH_SB_REL &&
+		    s->pc_cnt[2 * (j - 1)] >= s->sb_rel &&
+		    s->pc_cnt[2 * (j - 1) + 1] >= s->sb_rel)
+			continue;
+		lb = glp_get_col_lb(copy, j);
+		ub = glp_get_col_ub(copy, j);
+		for (dir = 0; dir < 2; ++dir) {
+			if (dir == 0)
+				search_set_bounds(copy, j, lb, floor(c->value));
+			else
+				search_set_bounds(copy, j, ceil(c->value), ub);
+			r = glp_simplex(copy, &parm);
+			if (r == 0 && glp_get_status(copy) == GLP_NOFEAS) {
+				delta = DBL_MAX; // The branch is infeasible.
+			} else if (r == 0 || r == GLP_EITLIM) {
+				// A bound, as the dual simplex only worsens it.
+				delta = sign * glp_get_obj_val(copy) - obj;
+				if (delta < 0)
+					delta = 0;
+				search_observe(s, j, dir, delta / (dir ?
+					ceil(c->value) - c->value :
+					c->value - floor(c->value)));
+			} else {
+				delta = dir ? c->up : c->down;
+			}
+			if (dir == 0)
+				c->down = delta;
+			else
+				c->up = delta;
+			// Back to the node's problem and basis.
+			search_set_bounds(copy, j, lb, ub);
+			for (i = 1; i <= m; ++i)
+				glp_set_row_stat(copy, i, stat[i]);
+			for (i = 1; i <= n; ++i)
+				glp_set_col_stat(copy, i, stat[m + i]);
+		}
+		c->evaluated = 1;
+		c->score = search_score(c->down, c->up);
+		++evaluated;
+	}
+	glp_delete_prob(copy);
+	free(stat);
+}
+
+/* At 'branch', estimate the node's best solution from the pseudocosts of
+   its fractional columns and, unless the user already did, branch upon
+   the column with the best product of its estimated changes, evaluated
+   by strong branching as sb_tech says. */
+static void search_branch(Search *s, glp_tree *tree, glp_prob *lp, int p,
+			  double sign, int acted)
+{
+	struct search_node *d = search_node(tree, p);
+	struct search_cand *cands = (struct search_cand*)s->cands, *c;
+	int j, n = glp_get_num_cols(lp), ncands = 0, known, sel = GLP_NO_BRNCH;
+	double f, best;
+
+	d->obj = sign * glp_get_obj_val(lp);
+	d->estimate = d->obj;
+	d->estimated = 1;
+	if (!search_alloc(s, lp))
+		return;
+	for (j = 1; j <= n; ++j) {
+		if (!glp_ios_can_branch(tree, j))
+			continue;
+		c = cands + ncands++;
+		c->column = j;
+		c->evaluated = 0;
+		c->value = glp_get_col_prim(lp, j);
+		f = c->value - floor(c->value);
+		c->down = search_pc(s, j, 0) * f;
+		c->up = search_pc(s, j, 1) * (1 - f);
+		d->estimate += c->down < c->up ? c->down : c->up;
+	}
+	if (acted || ncands == 0)
+		return;
+	if (s->sb_tech != SEARCH_SB_OFF) {
+		// Evaluate the most promising by their pseudocosts first.
+		known = s->pc_all_cnt[0] || s->pc_all_cnt[1];
+		for (c = cands; c < cands + ncands; ++c) {
+			f = c->value - floor(c->value);
+			c->score = known ? search_score(c->down, c->up) :
+				search_score(f, 1 - f);
+		}
+		qsort(cands, ncands, sizeof(*cands), search_cmp_score);
+		search_strong(s, lp, sign, cands, ncands);
+	}
+	// Score what was not evaluated with the pseudocosts now known.
+	known = s->pc_all_cnt[0] || s->pc_all_cnt[1];
+	for (c = cands; c < cands + ncands; ++c) {
+		if (c->evaluated)
+			continue;
+		f = c->value - floor(c->value);
+		if (known) {
+			c->down = search_pc(s, c->column, 0) * f;
+			c->up = search_pc(s, c->column, 1) * (1 - f);
+		} else {
+			// Until anything is observed, the most fractional.
+			c->down = f;
+			c->up = 1 - f;
+		}
+		c->score = search_score(c->down, c->up);
+	}
+	best = -1.0;
+	for (c = cands; c < cands + ncands; ++c) {
+		if (c->score > best) {
+			best = c->score;
+			d->column = c->column;
+			d->value = c->value;
+			// Go on with the child whose objective worsens less.
+			sel = c->down <= c->up ? GLP_DN_BRNCH : GLP_UP_BRNCH;
+		}
+	}
+	glp_ios_branch_upon(tree, d->column, sel);
+}
+
+/* The estimate of an active node, from its parent's if it has no own. */
+static double search_estimate(glp_tree *tree, int p, double sign)
+{
+	struct search_node *d = search_valid(tree, p);
+	int up;
+	if (d != NULL && d->estimated)
+		return d->estimate;
+	if ((up = glp_ios_up_node(tree, p)) != 0 &&
+	    (d = search_valid(tree, up)) != NULL && d->estimated)
+		return d->estimate;
+	return sign * glp_ios_node_bound(tree, p);
+}
+
+static void search_select(Search *s, glp_tree *tree)
+{
+	glp_prob *lp = glp_ios_get_prob(tree);
+	double sign = glp_get_obj_dir(lp) == GLP_MAX ? -1.0 : 1.0;
+	double est, bestest = DBL_MAX;
+	int p, level, bestlevel = -1, best = 0, mode = s->sel_tech;
+
+	++s->selects;
+	if (mode == SEARCH_SEL_DFP) {
+		mode = s->selects % s->sel_frq ? SEARCH_DEPTH : SEARCH_BOUND;
+	} else if (mode == SEARCH_SEL_HYB) {
+		// Find a solution, then improve it, then prove it.
+		if (glp_mip_status(lp) != GLP_FEAS)
+			mode = SEARCH_DEPTH;
+		else if (glp_ios_mip_gap(tree) > s->sel_gap)
+			mode = SEARCH_SEL_BEP;
+		else
+			mode = SEARCH_BOUND;
+	}
+	switch (mode) {
+	case SEARCH_BOUND:
+		best = glp_ios_best_node(tree);
+		break;
+	case SEARCH_DEPTH:
+		for (p = glp_ios_next_node(tree, 0); p;
+		     p = glp_ios_next_node(tree, p)) {
+			if ((level = glp_ios_node_level(tree, p)) >= bestlevel) {
+				bestlevel = level;
+				best = p;
+			}
+		}
+		break;
+	case SEARCH_SEL_BEP:
+		for (p = glp_ios_next_node(tree, 0); p;
+		     p = glp_ios_next_node(tree, p)) {
+			if ((est = search_estimate(tree, p, sign)) < bestest) {
+				bestest = est;
+				best = p;
+			}
+		}
+		break;
+	}
+	if (best != 0)
+		glp_ios_select_node(tree, best);
+}
+
+void Search_Callback(Search *s, glp_tree *tree, int acted)
+{
+	int reason = glp_ios_reason(tree), p;
+	glp_prob *lp;
+	double sign;
+
+	if (!Search_Active(s))
+		return;
+	if (reason == GLP_ISELECT) {
+		if (!acted)
+			search_select(s, tree);
+		return;
+	}
+	if (!search_branches(s) || reason == GLP_IPREPRO ||
+	    (p = glp_ios_curr_node(tree)) == 0)
+		return;
+	// For the other reasons the node's relaxation has been solved.
+	lp = glp_ios_get_prob(tree);
+	sign = glp_get_obj_dir(lp) == GLP_MAX ? -1.0 : 1.0;
+	search_learn(s, tree, lp, p, sign);
+	if (reason == GLP_IBRANCH)
+		search_branch(s, tree, lp, p, sign, acted);
+}
@@ -0,0 +1,77 @@
+/**************************************************************************
+Copyright (C) 2007, 2008 Thomas Finley, tfinley@gmail.com
+
+This file is part of PyGLPK.
+
+PyGLPK is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+PyGLPK is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with PyGLPK.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#ifndef _SEARCH_H
+#define _SEARCH_H
+
+#include <Python.h>
+#include <glpk.h>
+
+/* Search strategies of the integer solver implemented natively, upon the
+   glp_ios_* routines, and run from its callback without the GIL. */
+
+/* The node selection techniques, as the sel_tech of LPX.integer. */
+#define SEARCH_SEL_BT  0 // GLPK's own, as set by bt_tech.
+#define SEARCH_SEL_BEP 1 // Best estimate by pseudocosts.
+#define SEARCH_SEL_DFP 2 // Depth first, plunging to the best bound.
+#define SEARCH_SEL_HYB 3 // Hybrid, driven by the gap.
+
+/* The strong branching techniques, as the sb_tech of LPX.integer. */
+#define SEARCH_SB_OFF  0 // None, branching by pseudocosts or br_tech.
+#define SEARCH_SB_FULL 1 // Strong branching upon the best candidates.
+#define SEARCH_SB_REL  2 // Reliability branching.
+
+typedef struct {
+	int sel_tech; // One of the SEARCH_SEL_* values.
+	int sel_frq; // How often SEARCH_SEL_DFP selects the best bound.
+	double sel_gap; // The gap below which SEARCH_SEL_HYB bounds.
+	int sb_tech; // One of the SEARCH_SB_* values.
+	int sb_cand; // How many candidates are evaluated at most per node.
+	int sb_it_lim; // Dual simplex iterations per evaluated branch.
+	int sb_rel; // Observations making a column's pseudocosts reliable.
+	// The state of a solve, from Search_Prepare to Search_Clear.
+	int ncols; // The columns pseudocosts are kept for, once allocated.
+	double *pc_sum; // Per unit objective changes, 2 per column (down, up).
+	int *pc_cnt; // Observations of them, likewise.
+	void *cands; // Room for the branching candidates, one per column.
+	double pc_all[2]; // Those of every column, for unobserved ones.
+	int pc_all_cnt[2];
+	int selects; // How many nodes were selected.
+	unsigned int failed:1; // Whether the pseudocosts could not be kept.
+} Search;
+
+/* Whether the integer solver must call Search_Callback. */
+#define Search_Active(s) \
+	((s)->sel_tech != SEARCH_SEL_BT || (s)->sb_tech != SEARCH_SB_OFF)
+
+/* Set the default parameters, under which the search is inactive. */
+void Search_Init(Search *s);
+/* Check the parameters. Returns 0 with an exception set if invalid. */
+int Search_Check(Search *s);
+/* Before a solve, reset the state and reserve the node data the search
+   keeps, in cp, which must have no other use for it. */
+void Search_Prepare(Search *s, glp_iocp *cp);
+/* Run the search for the tree's current reason, after any callback of
+   the user, where acted is whether that callback already selected a node
+   at 'select', or branched at 'branch'. This does not need the GIL. */
+void Search_Callback(Search *s, glp_tree *tree, int acted);
+/* Release the state once the solve is over. */
+void Search_Clear(Search *s);
+
+#endif // _SEARCH_H
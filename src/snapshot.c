@@ -0,0 +1,1049 @@
+/**************************************************************************
+Copyright (C) 2007, 2008 Thomas Finley, tfinley@gmail.com
+
+This file is part of PyGLPK.
+
+PyGLPK is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+PyGLPK is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with PyGLPK.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#include "2to3.h"
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "snapshot.h"
+#include "util.h"
+
+#define SNAPSHOT_MAGIC "GLPKSNAP"
+#define SNAPSHOT_ORDER 0x01020304u // Read back differently if swapped.
+
+/* GLPK's own limits, past which it aborts rather than failing. */
+#define SNAPSHOT_MAX_ROWS 100000000
+#define SNAPSHOT_MAX_COLS 100000000
+#define SNAPSHOT_MAX_NNZ  500000000
+#define SNAPSHOT_MAX_NAME 255
+
+struct snapshot_header {
+	char magic[8];
+	uint32_t version, order;
+	int32_t m, n, nnz, dir;
+	int32_t sections; // The SNAPSHOT_* sections present.
+	int32_t last_solver; // As LPXObject's, or -1 for none.
+	uint64_t names_len, solution_len;
+};
+
+/* The offsets of the solution's arrays from the start of its section.
+   The statuses are the primal and dual ones of a basic solution, else the
+   solution's alone, and the rows' and columns' are only a basic
+   solution's; the duals are not a MIP solution's. */
+struct snapshot_values {
+	uint64_t stat, obj, row_stat, col_stat;
+	uint64_t row_prim, row_dual, col_prim, col_dual;
+	uint64_t size;
+};
+
+/* The offsets of the sections from the start of the snapshot. They are
+   computed in 64 bits, so that no sizes read from a header overflow. */
+struct snapshot_layout {
+	uint64_t obj, row_type, row_lb, row_ub;
+	uint64_t col_type, col_kind, col_lb, col_ub;
+	uint64_t ptr, ind, val, names, row_stat, col_stat, solution;
+	uint64_t size;
+};
+
+#define SECTION(field, bytes) \
+	(at = (at + 7) & ~(uint64_t)7, l->field = at, at += (bytes))
+
+static void snapshot_values_layout(uint64_t m, uint64_t n,
+				   struct snapshot_values *l)
+{
+	uint64_t at = 0;
+
+	SECTION(stat, 2 * sizeof(int));
+	SECTION(obj, sizeof(double));
+	SECTION(row_stat, m * sizeof(int));
+	SECTION(col_stat, n * sizeof(int));
+	SECTION(row_prim, m * sizeof(double));
+	SECTION(row_dual, m * sizeof(double));
+	SECTION(col_prim, n * sizeof(double));
+	SECTION(col_dual, n * sizeof(double));
+	l->size = at;
+}
+
+static void snapshot_layout(const struct snapshot_header *h,
+			    struct snapshot_layout *l)
+{
+	uint64_t m = h->m, n = h->n, nnz = h->nnz, at = sizeof *h;
+	int names = h->sections & SNAPSHOT_NAMES,
+		basis = h->sections & SNAPSHOT_BASIS,
+		solution = h->sections & SNAPSHOT_SOLUTION;
+
+	SECTION(obj, (n + 1) * sizeof(double));
+	SECTION(row_type, m * sizeof(int));
+	SECTION(row_lb, m * sizeof(double));
+	SECTION(row_ub, m * sizeof(double));
+	SECTION(col_type, n * sizeof(int));
+	SECTION(col_kind, n * sizeof(int));
+	SECTION(col_lb, n * sizeof(double));
+	SECTION(col_ub, n * sizeof(double));
+	SECTION(ptr, (m + 1) * sizeof(int));
+	SECTION(ind, (nnz + 1) * sizeof(int));
+	SECTION(val, (nnz + 1) * sizeof(double));
+	SECTION(names, names ? h->names_len : 0);
+	SECTION(row_stat, basis ? m * sizeof(int) : 0);
+	SECTION(col_stat, basis ? n * sizeof(int) : 0);
+	SECTION(solution, solution ? h->solution_len : 0);
+	l->size = at;
+}
+
+#undef SECTION
+
+/**************** WRITING **************/
+
+static void snapshot_header(const Snapshot *s, struct snapshot_header *h)
+{
+	glp_prob *lp = s->py_lp->lp;
+	memset(h, 0, sizeof *h);
+	memcpy(h->magic, SNAPSHOT_MAGIC, sizeof h->magic);
+	h->version = SNAPSHOT_VERSION;
+	h->order = SNAPSHOT_ORDER;
+	h->m = glp_get_num_rows(lp);
+	h->n = glp_get_num_cols(lp);
+	h->nnz = glp_get_num_nz(lp);
+	h->dir = glp_get_obj_dir(lp);
+	h->sections = s->sections;
+	h->last_solver = s->py_lp->last_solver <= 2 ?
+		(int32_t)s->py_lp->last_solver : -1;
+	h->names_len = s->names_len;
+	if (s->sections & SNAPSHOT_SOLUTION) {
+		struct snapshot_values v;
+		snapshot_values_layout(h->m, h->n, &v);
+		h->solution_len = v.size;
+	}
+}
+
+static size_t snapshot_name_len(const char *name)
+{
+	return (name ? strlen(name) : 0) + 1;
+}
+
+/* Write the values of the solution the last solver left into a zeroed
+   buffer of the problem's snapshot_values size, aligned to 8 bytes. */
+static void snapshot_put_values(glp_prob *lp, int last_solver, char *base)
+{
+	struct snapshot_values l;
+	int i, j, m = glp_get_num_rows(lp), n = glp_get_num_cols(lp);
+	int *stat = (int*)base, *row_stat, *col_stat;
+	double *obj, *row_prim, *row_dual, *col_prim, *col_dual;
+
+	snapshot_values_layout(m, n, &l);
+	obj = (double*)(base + l.obj);
+	row_stat = (int*)(base + l.row_stat);
+	col_stat = (int*)(base + l.col_stat);
+	row_prim = (double*)(base + l.row_prim);
+	row_dual = (double*)(base + l.row_dual);
+	col_prim = (double*)(base + l.col_prim);
+	col_dual = (double*)(base + l.col_dual);
+	switch (last_solver) {
+	case 1:
+		stat[0] = glp_ipt_status(lp);
+		*obj = glp_ipt_obj_val(lp);
+		for (i = 1; i <= m; ++i) {
+			row_prim[i-1] = glp_ipt_row_prim(lp, i);
+			row_dual[i-1] = glp_ipt_row_dual(lp, i);
+		}
+		for (j = 1; j <= n; ++j) {
+			col_prim[j-1] = glp_ipt_col_prim(lp, j);
+			col_dual[j-1] = glp_ipt_col_dual(lp, j);
+		}
+		break;
+	case 2:
+		stat[0] = glp_mip_status(lp);
+		*obj = glp_mip_obj_val(lp);
+		for (i = 1; i <= m; ++i)
+			row_prim[i-1] = glp_mip_row_val(lp, i);
+		for (j = 1; j <= n; ++j)
+			col_prim[j-1] = glp_mip_col_val(lp, j);
+		break;
+	default:
+		stat[0] = glp_get_prim_stat(lp);
+		stat[1] = glp_get_dual_stat(lp);
+		*obj = glp_get_obj_val(lp);
+		for (i = 1; i <= m; ++i) {
+			row_stat[i-1] = glp_get_row_stat(lp, i);
+			row_prim[i-1] = glp_get_row_prim(lp, i);
+			row_dual[i-1] = glp_get_row_dual(lp, i);
+		}
+		for (j = 1; j <= n; ++j) {
+			col_stat[j-1] = glp_get_col_stat(lp, j);
+			col_prim[j-1] = glp_get_col_prim(lp, j);
+			col_dual[j-1] = glp_get_col_dual(lp, j);
+		}
+		break;
+	}
+}
+
+int Snapshot_Prepare(Snapshot *s, LPXObject *py_lp, int sections)
+{
+	glp_prob *lp = py_lp->lp;
+	struct snapshot_header h;
+	struct snapshot_layout l;
+	int i, m = glp_get_num_rows(lp), n = glp_get_num_cols(lp);
+
+	s->py_lp = py_lp;
+	s->names_len = 0;
+	if (py_lp->last_solver > 2)
+		sections &= ~SNAPSHOT_SOLUTION;
+	s->sections = sections;
+	if (sections & SNAPSHOT_NAMES) {
+		s->names_len = snapshot_name_len(glp_get_prob_name(lp)) +
+			snapshot_name_len(glp_get_obj_name(lp));
+		for (i = 1; i <= m; ++i)
+			s->names_len += snapshot_name_len(glp_get_row_name(lp, i));
+		for (i = 1; i <= n; ++i)
+			s->names_len += snapshot_name_len(glp_get_col_name(lp, i));
+	}
+	snapshot_header(s, &h);
+	snapshot_layout(&h, &l);
+	s->size = (size_t)l.size;
+	if (s->size != l.size) {
+		PyErr_NoMemory();
+		return 0;
+	}
+	return 1;
+}
+
+static char *snapshot_put_name(char *at, const char *name)
+{
+	size_t len = snapshot_name_len(name);
+	memcpy(at, name ? name : "", len);
+	return at + len;
+}
+
+void Snapshot_Fill(const Snapshot *s, void *buf)
+{
+	glp_prob *lp = s->py_lp->lp;
+	struct snapshot_header h;
+	struct snapshot_layout l;
+	char *base = buf, *names;
+	int i, j, *type, *kind, *ptr, *ind, *stat;
+	double *obj, *lb, *ub, *val;
+
+	snapshot_header(s, &h);
+	snapshot_layout(&h, &l);
+	// Zero the padding and the unused first slots of ind and val.
+	memset(base, 0, s->size);
+	memcpy(base, &h, sizeof h);
+
+	obj = (double*)(base + l.obj);
+	for (j = 0; j <= h.n; ++j)
+		obj[j] = glp_get_obj_coef(lp, j);
+
+	type = (int*)(base + l.row_type);
+	lb = (double*)(base + l.row_lb);
+	ub = (double*)(base + l.row_ub);
+	for (i = 1; i <= h.m; ++i) {
+		type[i-1] = glp_get_row_type(lp, i);
+		lb[i-1] = glp_get_row_lb(lp, i);
+		ub[i-1] = glp_get_row_ub(lp, i);
+	}
+	type = (int*)(base + l.col_type);
+	kind = (int*)(base + l.col_kind);
+	lb = (double*)(base + l.col_lb);
+	ub = (double*)(base + l.col_ub);
+	for (j = 1; j <= h.n; ++j) {
+		type[j-1] = glp_get_col_type(lp, j);
+		kind[j-1] = glp_get_col_kind(lp, j);
+		lb[j-1] = glp_get_col_lb(lp, j);
+		ub[j-1] = glp_get_col_ub(lp, j);
+	}
+
+	// Each row is fetched straight into place, from [ptr[i-1]+1] on.
+	ptr = (int*)(base + l.ptr);
+	ind = (int*)(base + l.ind);
+	val = (double*)(base + l.val);
+	ptr[0] = 0;
+	for (i = 1; i <= h.m; ++i)
+		ptr[i] = ptr[i-1] + glp_get_mat_row(lp, i, ind + ptr[i-1],
+						    val + ptr[i-1]);
+
+	if (h.sections & SNAPSHOT_NAMES) {
+		names = base + l.names;
+		names = snapshot_put_name(names, glp_get_prob_name(lp));
+		names = snapshot_put_name(names, glp_get_obj_name(lp));
+		for (i = 1; i <= h.m; ++i)
+			names = snapshot_put_name(names, glp_get_row_name(lp, i));
+		for (j = 1; j <= h.n; ++j)
+			names = snapshot_put_name(names, glp_get_col_name(lp, j));
+	}
+	if (h.sections & SNAPSHOT_BASIS) {
+		stat = (int*)(base + l.row_stat);
+		for (i = 1; i <= h.m; ++i)
+			stat[i-1] = glp_get_row_stat(lp, i);
+		stat = (int*)(base + l.col_stat);
+		for (j = 1; j <= h.n; ++j)
+			stat[j-1] = glp_get_col_stat(lp, j);
+	}
+	if (h.sections & SNAPSHOT_SOLUTION)
+		snapshot_put_values(lp, s->py_lp->last_solver,
+				    base + l.solution);
+}
+
+/**************** READING **************/
+
+static int snapshot_invalid(const char *why)
+{
+	PyErr_Format(PyExc_ValueError, "not a valid snapshot: %s", why);
+	return 0;
+}
+
+static int snapshot_check_ints(const int *a, int len, int lo, int hi)
+{
+	int i;
+	for (i = 0; i < len; ++i)
+		if (a[i] < lo || a[i] > hi)
+			return 0;
+	return 1;
+}
+
+/* Check all that GLPK would abort upon rather than fail, before anything
+   is loaded. */
+static int snapshot_check(const struct snapshot_header *h,
+			  const struct snapshot_layout *l, const char *base)
+{
+	const int *ptr = (const int*)(base + l->ptr),
+		*ind = (const int*)(base + l->ind);
+	const char *names = base + l->names, *end, *at;
+	int i, k, count, dup, *mark;
+
+	if (h->dir != GLP_MIN && h->dir != GLP_MAX)
+		return snapshot_invalid("bad objective direction");
+	if (!snapshot_check_ints((const int*)(base + l->row_type), h->m,
+				 GLP_FR, GLP_FX) ||
+	    !snapshot_check_ints((const int*)(base + l->col_type), h->n,
+				 GLP_FR, GLP_FX))
+		return snapshot_invalid("bad bound type");
+	if (!snapshot_check_ints((const int*)(base + l->col_kind), h->n,
+				 GLP_CV, GLP_BV))
+		return snapshot_invalid("bad column kind");
+
+	if (ptr[0] != 0 || ptr[h->m] != h->nnz)
+		return snapshot_invalid("bad matrix row offsets");
+	for (i = 1; i <= h->m; ++i)
+		if (ptr[i] < ptr[i-1])
+			return snapshot_invalid("bad matrix row offsets");
+	if (!snapshot_check_ints(ind + 1, h->nnz, 1, h->n))
+		return snapshot_invalid("matrix column index out of range");
+	// Mark each column with the last row it was seen in.
+	if ((mark = PyMem_Malloc((h->n + 1) * sizeof(int))) == NULL) {
+		PyErr_NoMemory();
+		return 0;
+	}
+	memset(mark, 0, (h->n + 1) * sizeof(int));
+	for (dup = 0, i = 1; !dup && i <= h->m; ++i)
+		for (k = ptr[i-1] + 1; k <= ptr[i]; ++k) {
+			if ((dup = mark[ind[k]] == i))
+				break;
+			mark[ind[k]] = i;
+		}
+	PyMem_Free(mark);
+	if (dup)
+		return snapshot_invalid("duplicate matrix element");
+
+	if (h->sections & SNAPSHOT_NAMES) {
+		end = names + h->names_len;
+		for (count = 0, at = names; at < end; ++count, ++at) {
+			for (k = 0; at < end && *at; ++at, ++k)
+				if (k == SNAPSHOT_MAX_NAME ||
+				    iscntrl((unsigned char)*at))
+					return snapshot_invalid("bad name");
+			if (at == end)
+				return snapshot_invalid("bad names");
+		}
+		if (count != 2 + h->m + h->n)
+			return snapshot_invalid("bad names");
+	}
+	if (h->sections & SNAPSHOT_BASIS &&
+	    (!snapshot_check_ints((const int*)(base + l->row_stat), h->m,
+				  GLP_BS, GLP_NS) ||
+	     !snapshot_check_ints((const int*)(base + l->col_stat), h->n,
+				  GLP_BS, GLP_NS)))
+		return snapshot_invalid("bad basis status");
+	return 1;
+}
+
+/* Read GLPK's own file of the last solver's solution into the problem,
+   which must have the rows and columns it was written from. */
+static int snapshot_read_solution(LPXObject *py_lp, int last_solver,
+				  const char *data, size_t len)
+{
+	util_memfile f;
+	int failed, term;
+
+	if (!util_memfile_open(&f, data, len))
+		return 0;
+	term = glp_term_out(GLP_OFF);
+	switch (last_solver) {
+	case 1:
+		failed = glp_read_ipt(py_lp->lp, f.path);
+		break;
+	case 2:
+		failed = glp_read_mip(py_lp->lp, f.path);
+		break;
+	default:
+		failed = glp_read_sol(py_lp->lp, f.path);
+		break;
+	}
+	glp_term_out(term);
+	util_memfile_close(&f);
+	if (failed)
+		return snapshot_invalid("bad solution");
+	py_lp->last_solver = last_solver;
+	return 1;
+}
+
+/* The longest line written for a row or column, or the status. */
+#define SNAPSHOT_LINE 80
+
+/* The letter GLPK's solution files use for a status, else '?'. */
+static char snapshot_code(const char *codes, int stat)
+{
+	return stat > 0 && stat < (int)strlen(codes) ? codes[stat] : '?';
+}
+
+/* Print a row's or column's line of a solution file. */
+static int snapshot_print(char *at, char what, int k, int last_solver,
+			  int stat, double prim, double dual)
+{
+#if GLPK_VERSION(4, 57)
+	switch (last_solver) {
+	case 1:
+		return sprintf(at, "%c %d %.17g %.17g\n", what, k, prim, dual);
+	case 2:
+		return sprintf(at, "%c %d %.17g\n", what, k, prim);
+	default:
+		return sprintf(at, "%c %d %c %.17g %.17g\n", what, k,
+			       snapshot_code("?blufs", stat), prim, dual);
+	}
+#else
+	switch (last_solver) {
+	case 1:
+		return sprintf(at, "%.17g %.17g\n", prim, dual);
+	case 2:
+		return sprintf(at, "%.17g\n", prim);
+	default:
+		return sprintf(at, "%d %.17g %.17g\n", stat, prim, dual);
+	}
+#endif
+}
+
+/* Assign the values of snapshot_put_values through GLPK's reader of the
+   last solver's solution file, generated from them with 17 significant
+   digits, so that every value reads back exactly as it was. The problem
+   must have the rows and columns they were taken from. */
+static int snapshot_read_values(LPXObject *py_lp, int last_solver,
+				const char *base)
+{
+	struct snapshot_values l;
+	int i, j, ok, m = glp_get_num_rows(py_lp->lp),
+		n = glp_get_num_cols(py_lp->lp);
+	const int *stat = (const int*)base, *row_stat, *col_stat;
+	const double *obj, *row_prim, *row_dual, *col_prim, *col_dual;
+	char *text, *at;
+
+	snapshot_values_layout(m, n, &l);
+	obj = (const double*)(base + l.obj);
+	row_stat = (const int*)(base + l.row_stat);
+	col_stat = (const int*)(base + l.col_stat);
+	row_prim = (const double*)(base + l.row_prim);
+	row_dual = (const double*)(base + l.row_dual);
+	col_prim = (const double*)(base + l.col_prim);
+	col_dual = (const double*)(base + l.col_dual);
+	if ((at = text = PyMem_Malloc(((size_t)m + n + 3) * SNAPSHOT_LINE))
+	    == NULL) {
+		PyErr_NoMemory();
+		return 0;
+	}
+#if GLPK_VERSION(4, 57)
+	switch (last_solver) {
+	case 1:
+		at += sprintf(at, "s ipt %d %d %c %.17g\n", m, n,
+			      snapshot_code("?ufino", stat[0]), *obj);
+		break;
+	case 2:
+		at += sprintf(at, "s mip %d %d %c %.17g\n", m, n,
+			      snapshot_code("?ufino", stat[0]), *obj);
+		break;
+	default:
+		at += sprintf(at, "s bas %d %d %c %c %.17g\n", m, n,
+			      snapshot_code("?ufino", stat[0]),
+			      snapshot_code("?ufino", stat[1]), *obj);
+		break;
+	}
+#else
+	at += sprintf(at, "%d %d\n", m, n);
+	if (last_solver == 0)
+		at += sprintf(at, "%d %d %.17g\n", stat[0], stat[1], *obj);
+	else
+		at += sprintf(at, "%d %.17g\n", stat[0], *obj);
+#endif
+	for (i = 1; i <= m; ++i)
+		at += snapshot_print(at, 'i', i, last_solver, row_stat[i-1],
+				     row_prim[i-1], row_dual[i-1]);
+	for (j = 1; j <= n; ++j)
+		at += snapshot_print(at, 'j', j, last_solver, col_stat[j-1],
+				     col_prim[j-1], col_dual[j-1]);
+#if GLPK_VERSION(4, 57)
+	at += sprintf(at, "e o f\n");
+#endif
+	ok = snapshot_read_solution(py_lp, last_solver, text, at - text);
+	PyMem_Free(text);
+	return ok;
+}
+
+static int snapshot_build(LPXObject *py_lp, const struct snapshot_header *h,
+			  const struct snapshot_layout *l, const char *base)
+{
+	glp_prob *lp = py_lp->lp;
+	const int *type, *kind, *ptr = (const int*)(base + l->ptr), *stat;
+	const double *obj = (const double*)(base + l->obj), *lb, *ub;
+	const char *names;
+	int i, j, k, *ia;
+
+	glp_set_obj_dir(lp, h->dir);
+	if (h->m)
+		glp_add_rows(lp, h->m);
+	if (h->n)
+		glp_add_cols(lp, h->n);
+	for (j = 0; j <= h->n; ++j)
+		glp_set_obj_coef(lp, j, obj[j]);
+
+	type = (const int*)(base + l->row_type);
+	lb = (const double*)(base + l->row_lb);
+	ub = (const double*)(base + l->row_ub);
+	for (i = 1; i <= h->m; ++i)
+		glp_set_row_bnds(lp, i, type[i-1], lb[i-1], ub[i-1]);
+	type = (const int*)(base + l->col_type);
+	kind = (const int*)(base + l->col_kind);
+	lb = (const double*)(base + l->col_lb);
+	ub = (const double*)(base + l->col_ub);
+	for (j = 1; j <= h->n; ++j) {
+		glp_set_col_bnds(lp, j, type[j-1], lb[j-1], ub[j-1]);
+		if (kind[j-1] != GLP_CV)
+			glp_set_col_kind(lp, j, kind[j-1]);
+	}
+
+	// The column indices and values are GLPK's arrays as they are, and
+	// only the row indices are expanded from the offsets.
+	if (h->nnz) {
+		if ((ia = PyMem_Malloc((h->nnz + 1) * sizeof(int))) == NULL) {
+			PyErr_NoMemory();
+			return 0;
+		}
+		for (i = 1; i <= h->m; ++i)
+			for (k = ptr[i-1] + 1; k <= ptr[i]; ++k)
+				ia[k] = i;
+		glp_load_matrix(lp, h->nnz, ia, (const int*)(base + l->ind),
+				(const double*)(base + l->val));
+		PyMem_Free(ia);
+	}
+
+	if (h->sections & SNAPSHOT_NAMES) {
+		names = base + l->names;
+		glp_set_prob_name(lp, names);
+		names += strlen(names) + 1;
+		glp_set_obj_name(lp, names);
+		names += strlen(names) + 1;
+		for (i = 1; i <= h->m; ++i, names += strlen(names) + 1)
+			glp_set_row_name(lp, i, names);
+		for (j = 1; j <= h->n; ++j, names += strlen(names) + 1)
+			glp_set_col_name(lp, j, names);
+	}
+	if (h->sections & SNAPSHOT_BASIS) {
+		stat = (const int*)(base + l->row_stat);
+		for (i = 1; i <= h->m; ++i)
+			glp_set_row_stat(lp, i, stat[i-1]);
+		stat = (const int*)(base + l->col_stat);
+		for (j = 1; j <= h->n; ++j)
+			glp_set_col_stat(lp, j, stat[j-1]);
+	}
+
+	if (!(h->sections & SNAPSHOT_SOLUTION))
+		return 1;
+	return snapshot_read_values(py_lp, h->last_solver, base + l->solution);
+}
+
+int Snapshot_Load(LPXObject *py_lp, const void *buf, size_t len)
+{
+	struct snapshot_header h;
+	struct snapshot_layout l;
+	const char *base = buf;
+	void *aligned = NULL;
+	int ok;
+
+	if (len < sizeof h)
+		return snapshot_invalid("too short");
+	memcpy(&h, base, sizeof h);
+	if (memcmp(h.magic, SNAPSHOT_MAGIC, sizeof h.magic))
+		return snapshot_invalid("bad magic number");
+	if (h.order != SNAPSHOT_ORDER)
+		return snapshot_invalid("written in another byte order");
+	if (h.version != SNAPSHOT_VERSION) {
+		PyErr_Format(PyExc_ValueError, "snapshot version %u is not "
+			     "supported", (unsigned)h.version);
+		return 0;
+	}
+	if (h.m < 0 || h.m > SNAPSHOT_MAX_ROWS || h.n < 0 ||
+	    h.n > SNAPSHOT_MAX_COLS || h.nnz < 0 || h.nnz > SNAPSHOT_MAX_NNZ ||
+	    h.sections & ~SNAPSHOT_ALL ||
+	    h.last_solver < -1 || h.last_solver > 2 ||
+	    (h.sections & SNAPSHOT_SOLUTION && h.last_solver < 0) ||
+	    h.names_len > len || h.solution_len > len)
+		return snapshot_invalid("bad header");
+	if (h.sections & SNAPSHOT_SOLUTION) {
+		struct snapshot_values v;
+		snapshot_values_layout(h.m, h.n, &v);
+		if (h.solution_len != v.size)
+			return snapshot_invalid("bad header");
+	}
+	snapshot_layout(&h, &l);
+	if (l.size > len)
+		return snapshot_invalid("truncated");
+	if (glp_get_num_rows(py_lp->lp) || glp_get_num_cols(py_lp->lp)) {
+		PyErr_SetString(PyExc_RuntimeError, "problem is not empty");
+		return 0;
+	}
+	// The arrays are used in place, which needs them aligned.
+	if ((uintptr_t)base % 8) {
+		if ((aligned = PyMem_Malloc(len)) == NULL) {
+			PyErr_NoMemory();
+			return 0;
+		}
+		base = memcpy(aligned, base, len);
+	}
+	ok = snapshot_check(&h, &l, base) && snapshot_build(py_lp, &h, &l, base);
+	PyMem_Free(aligned);
+	return ok;
+}
+
+PyObject *Snapshot_ToBytes(LPXObject *py_lp, int sections)
+{
+	PyObject *bytes;
+	Snapshot s;
+
+	if (!Snapshot_Prepare(&s, py_lp, sections))
+		return NULL;
+	// The bytes' contents are aligned as the allocator's blocks are.
+	bytes = PyBytes_FromStringAndSize(NULL, s.size);
+	if (bytes != NULL)
+		Snapshot_Fill(&s, PyBytes_AS_STRING(bytes));
+	return bytes;
+}
+
+/**************** FILES **************/
+
+/* Map the named file into memory, or where that is not available read it.
+   Returns 0 with an exception set on failure. */
+static int snapshot_map(const char *name, void **data, size_t *size)
+{
+#ifndef _WIN32
+	struct stat st;
+	int fd;
+
+	if ((fd = open(name, O_RDONLY)) < 0 || fstat(fd, &st) < 0) {
+		PyErr_SetFromErrnoWithFilename(PyExc_IOError, name);
+		if (fd >= 0)
+			close(fd);
+		return 0;
+	}
+	*size = (size_t)st.st_size;
+	*data = NULL;
+	if (*size && (*data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd,
+				   0)) == MAP_FAILED) {
+		PyErr_SetFromErrnoWithFilename(PyExc_IOError, name);
+		close(fd);
+		return 0;
+	}
+	// The mapping outlives the descriptor.
+	close(fd);
+	return 1;
+#else
+	FILE *file;
+	long len = -1;
+
+	*data = NULL;
+	if ((file = fopen(name, "rb")) == NULL) {
+		PyErr_SetFromErrnoWithFilename(PyExc_IOError, name);
+		return 0;
+	}
+	if (fseek(file, 0, SEEK_END) != 0 || (len = ftell(file)) < 0 ||
+	    fseek(file, 0, SEEK_SET) != 0 ||
+	    (*data = PyMem_Malloc(len ? len : 1)) == NULL ||
+	    (long)fread(*data, 1, len, file) != len) {
+		if (*data == NULL && len >= 0)
+			PyErr_NoMemory();
+		else
+			PyErr_SetFromErrnoWithFilename(PyExc_IOError, name);
+		PyMem_Free(*data);
+		fclose(file);
+		return 0;
+	}
+	fclose(file);
+	*size = (size_t)len;
+	return 1;
+#endif
+}
+
+static void snapshot_unmap(void *data, size_t size)
+{
+#ifndef _WIN32
+	if (data != NULL)
+		munmap(data, size);
+#else
+	PyMem_Free(data);
+#endif
+}
+
+PyObject *Snapshot_SaveFile(LPXObject *py_lp, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = {"path", "names", "basis", "solution", NULL};
+	int names = 1, basis = 1, solution = 1, ok;
+	PyObject *path = NULL;
+	const char *name;
+	Snapshot s;
+	FILE *file;
+	void *buf;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&|iii:save_snapshot",
+					 kwlist, PyUnicode_FSConverter, &path,
+					 &names, &basis, &solution))
+		return NULL;
+	name = PyBytes_AS_STRING(path);
+	if (!Snapshot_Prepare(&s, py_lp, (names ? SNAPSHOT_NAMES : 0) |
+			      (basis ? SNAPSHOT_BASIS : 0) |
+			      (solution ? SNAPSHOT_SOLUTION : 0))) {
+		Py_DECREF(path);
+		return NULL;
+	}
+	if ((buf = PyMem_Malloc(s.size)) == NULL) {
+		Py_DECREF(path);
+		return PyErr_NoMemory();
+	}
+	Snapshot_Fill(&s, buf);
+
+	Py_BEGIN_ALLOW_THREADS
+	file = fopen(name, "wb");
+	ok = file != NULL && fwrite(buf, 1, s.size, file) == s.size;
+	if (file != NULL && fclose(file) != 0)
+		ok = 0;
+	Py_END_ALLOW_THREADS
+	PyMem_Free(buf);
+	if (!ok)
+		PyErr_SetFromErrnoWithFilename(PyExc_IOError, name);
+	Py_DECREF(path);
+	if (!ok)
+		return NULL;
+	Py_RETURN_NONE;
+}
+
+PyObject *Snapshot_LoadFile(PyTypeObject *type, PyObject *args,
+			    PyObject *kwds)
+{
+	static char *kwlist[] = {"path", NULL};
+	PyObject *path = NULL, *lpx = NULL;
+	void *data;
+	size_t size;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&:load_snapshot",
+					 kwlist, PyUnicode_FSConverter, &path))
+		return NULL;
+	if (snapshot_map(PyBytes_AS_STRING(path), &data, &size)) {
+		lpx = PyObject_CallObject((PyObject*)type, NULL);
+		if (lpx != NULL &&
+		    !Snapshot_Load((LPXObject*)lpx, data ? data : "", size))
+			Py_CLEAR(lpx);
+		snapshot_unmap(data, size);
+	}
+	Py_DECREF(path);
+	return lpx;
+}
+
+/**************** SHARED MEMORY **************/
+
+#define SNAPSHOT_SOLUTION_MAGIC "GLPKSOLN"
+
+/* A segment holding a solution has this header, then len bytes of its
+   values, laid out as a snapshot's solution section. */
+struct snapshot_solution_header {
+	char magic[8];
+	uint32_t version, order;
+	int32_t m, n, last_solver, unused;
+	uint64_t len;
+};
+
+/* Get a buffer upon the memory of a SharedMemory. 0 on failure. */
+static int snapshot_shm_buffer(PyObject *shm, Py_buffer *view, int flags)
+{
+	PyObject *buf = PyObject_GetAttrString(shm, "buf");
+	int ok;
+	if (buf == NULL)
+		return 0;
+	ok = PyObject_GetBuffer(buf, view, flags) == 0;
+	Py_DECREF(buf);
+	return ok;
+}
+
+/* Create a new SharedMemory of size bytes, with a writable buffer upon it
+   in view. Returns NULL with an exception set on failure. */
+static PyObject *snapshot_shm_create(size_t size, Py_buffer *view)
+{
+	PyObject *module, *shm, *exc, *val, *tb;
+
+	if (size > PY_SSIZE_T_MAX)
+		return PyErr_NoMemory();
+	module = PyImport_ImportModule("multiprocessing.shared_memory");
+	if (module == NULL)
+		return NULL;
+	shm = PyObject_CallMethod(module, "SharedMemory", "Oin", Py_None, 1,
+				  (Py_ssize_t)size);
+	Py_DECREF(module);
+	if (shm == NULL || snapshot_shm_buffer(shm, view, PyBUF_WRITABLE))
+		return shm;
+	// Do not leave the segment behind, nor lose why it failed.
+	PyErr_Fetch(&exc, &val, &tb);
+	Py_XDECREF(PyObject_CallMethod(shm, "close", NULL));
+	Py_XDECREF(PyObject_CallMethod(shm, "unlink", NULL));
+	PyErr_Clear();
+	PyErr_Restore(exc, val, tb);
+	Py_DECREF(shm);
+	return NULL;
+}
+
+/* Open the existing SharedMemory of the given name. */
+static PyObject *snapshot_shm_open(PyObject *module, PyObject *name)
+{
+#if PY_VERSION_HEX >= 0x030D0000
+	PyObject *cls, *args, *kwds, *shm = NULL;
+	// The segment belongs to the process that created it, whose resource
+	// tracker alone should ever unlink it.
+	cls = PyObject_GetAttrString(module, "SharedMemory");
+	args = PyTuple_Pack(1, name);
+	kwds = Py_BuildValue("{s:O}", "track", Py_False);
+	if (cls != NULL && args != NULL && kwds != NULL)
+		shm = PyObject_Call(cls, args, kwds);
+	Py_XDECREF(cls);
+	Py_XDECREF(args);
+	Py_XDECREF(kwds);
+	return shm;
+#else
+	return PyObject_CallMethod(module, "SharedMemory", "O", name);
+#endif
+}
+
+/* Release a reference to a segment, first closing it if it was attached
+   by name. Any exception already set is kept over one from closing. 
+   Returns 0 if closing it failed. */
+static int snapshot_shm_close(PyObject *shm, int attached)
+{
+	PyObject *exc, *val, *tb, *closed;
+	int ok = 1;
+
+	if (attached) {
+		PyErr_Fetch(&exc, &val, &tb);
+		closed = PyObject_CallMethod(shm, "close", NULL);
+		ok = closed != NULL;
+		Py_XDECREF(closed);
+		if (exc != NULL) {
+			PyErr_Clear();
+			PyErr_Restore(exc, val, tb);
+		}
+	}
+	Py_DECREF(shm);
+	return ok;
+}
+
+/* Attach to the segment of a handle, a SharedMemory or the name of one,
+   getting a buffer upon it. Whether it was attached by name, and so must
+   be closed by snapshot_shm_detach, is set in attached. */
+static PyObject *snapshot_shm_attach(PyObject *handle, Py_buffer *view,
+				     int *attached)
+{
+	PyObject *module, *shm;
+
+	*attached = PyUnicode_Check(handle);
+	if (!*attached) {
+		Py_INCREF(handle);
+		shm = handle;
+	} else {
+		module = PyImport_ImportModule("multiprocessing.shared_memory");
+		if (module == NULL)
+			return NULL;
+		shm = snapshot_shm_open(module, handle);
+		Py_DECREF(module);
+		if (shm == NULL)
+			return NULL;
+	}
+	if (snapshot_shm_buffer(shm, view, PyBUF_SIMPLE))
+		return shm;
+	snapshot_shm_close(shm, *attached);
+	return NULL;
+}
+
+/* Release the buffer and segment of snapshot_shm_attach. Returns 0 with
+   an exception set if closing the segment failed. */
+static int snapshot_shm_detach(PyObject *shm, Py_buffer *view, int attached)
+{
+	PyBuffer_Release(view);
+	return snapshot_shm_close(shm, attached);
+}
+
+PyObject *Snapshot_ToSharedMemory(LPXObject *py_lp, PyObject *args,
+				  PyObject *kwds)
+{
+	static char *kwlist[] = {"names", "basis", "solution", NULL};
+	int names = 1, basis = 1, solution = 1;
+	PyObject *shm;
+	Py_buffer view;
+	Snapshot s;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iii:to_shared_memory",
+					 kwlist, &names, &basis, &solution))
+		return NULL;
+	if (!Snapshot_Prepare(&s, py_lp, (names ? SNAPSHOT_NAMES : 0) |
+			      (basis ? SNAPSHOT_BASIS : 0) |
+			      (solution ? SNAPSHOT_SOLUTION : 0)))
+		return NULL;
+	// The snapshot is written straight into the segment.
+	if ((shm = snapshot_shm_create(s.size, &view)) != NULL) {
+		Snapshot_Fill(&s, view.buf);
+		PyBuffer_Release(&view);
+	}
+	return shm;
+}
+
+PyObject *Snapshot_FromSharedMemory(PyTypeObject *type, PyObject *args,
+				    PyObject *kwds)
+{
+	static char *kwlist[] = {"handle", NULL};
+	PyObject *handle, *shm, *lpx;
+	Py_buffer view;
+	int attached;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O:from_shared_memory",
+					 kwlist, &handle))
+		return NULL;
+	if ((shm = snapshot_shm_attach(handle, &view, &attached)) == NULL)
+		return NULL;
+	lpx = PyObject_CallObject((PyObject*)type, NULL);
+	if (lpx != NULL && !Snapshot_Load((LPXObject*)lpx, view.buf, view.len))
+		Py_CLEAR(lpx);
+	if (!snapshot_shm_detach(shm, &view, attached))
+		Py_CLEAR(lpx);
+	return lpx;
+}
+
+PyObject *Snapshot_SolutionToSharedMemory(LPXObject *py_lp, PyObject *noargs)
+{
+	struct snapshot_solution_header h;
+	struct snapshot_values v;
+	PyObject *shm;
+	Py_buffer view;
+
+	if (py_lp->last_solver > 2) {
+		PyErr_SetString(PyExc_RuntimeError, "no solver has been run");
+		return NULL;
+	}
+	memset(&h, 0, sizeof h);
+	memcpy(h.magic, SNAPSHOT_SOLUTION_MAGIC, sizeof h.magic);
+	h.version = SNAPSHOT_VERSION;
+	h.order = SNAPSHOT_ORDER;
+	h.m = glp_get_num_rows(py_lp->lp);
+	h.n = glp_get_num_cols(py_lp->lp);
+	h.last_solver = py_lp->last_solver;
+	snapshot_values_layout(h.m, h.n, &v);
+	h.len = v.size;
+	// The values are written straight into the segment.
+	if ((shm = snapshot_shm_create(sizeof h + h.len, &view)) != NULL) {
+		memset(view.buf, 0, sizeof h + h.len);
+		memcpy(view.buf, &h, sizeof h);
+		snapshot_put_values(py_lp->lp, h.last_solver,
+				    (char*)view.buf + sizeof h);
+		PyBuffer_Release(&view);
+	}
+	return shm;
+}
+
+PyObject *Snapshot_SolutionFromSharedMemory(LPXObject *py_lp,
+					    PyObject *args)
+{
+	struct snapshot_solution_header h;
+	struct snapshot_values v;
+	PyObject *handle, *shm;
+	Py_buffer view;
+	const char *values;
+	void *aligned = NULL;
+	int attached, ok = 0;
+
+	if (!LPX_CheckChange(py_lp))
+		return NULL;
+	if (!PyArg_ParseTuple(args, "O:solution_from_shared_memory",
+			      &handle))
+		return NULL;
+	if ((shm = snapshot_shm_attach(handle, &view, &attached)) == NULL)
+		return NULL;
+	if ((size_t)view.len < sizeof h)
+		goto invalid;
+	memcpy(&h, view.buf, sizeof h);
+	if (memcmp(h.magic, SNAPSHOT_SOLUTION_MAGIC, sizeof h.magic) ||
+	    h.order != SNAPSHOT_ORDER || h.version != SNAPSHOT_VERSION ||
+	    h.last_solver < 0 || h.last_solver > 2 ||
+	    h.len > (size_t)view.len - sizeof h)
+		goto invalid;
+	if (h.m != glp_get_num_rows(py_lp->lp) ||
+	    h.n != glp_get_num_cols(py_lp->lp)) {
+		PyErr_SetString(PyExc_ValueError, "solution is of a problem "
+				"with other dimensions");
+		goto done;
+	}
+	snapshot_values_layout(h.m, h.n, &v);
+	if (h.len != v.size)
+		goto invalid;
+	// The arrays are used in place, which needs them aligned.
+	values = (const char*)view.buf + sizeof h;
+	if ((uintptr_t)values % 8) {
+		if ((aligned = PyMem_Malloc(h.len)) == NULL) {
+			PyErr_NoMemory();
+			goto done;
+		}
+		values = memcpy(aligned, values, h.len);
+	}
+	ok = snapshot_read_values(py_lp, h.last_solver, values);
+	PyMem_Free(aligned);
+	goto done;
+invalid:
+	PyErr_SetString(PyExc_ValueError, "not a valid shared solution");
+done:
+	if (!snapshot_shm_detach(shm, &view, attached))
+		ok = 0;
+	if (!ok)
+		return NULL;
+	Py_RETURN_NONE;
+}
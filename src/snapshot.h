@@ -0,0 +1,116 @@
+/**************************************************************************
+Copyright (C) 2007, 2008 Thomas Finley, tfinley@gmail.com
+
+This file is part of PyGLPK.
+
+PyGLPK is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+PyGLPK is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with PyGLPK.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H
+
+#include <Python.h>
+#include <glpk.h>
+#include "lp.h"
+
+/* Binary snapshots of a problem.
+
+   A snapshot holds a problem's arrays as GLPK takes them, so that loading
+   one is a matter of validating it and handing the arrays over, without
+   parsing any text. It is laid out as a header followed by sections, each
+   starting on an 8-byte boundary, in the writer's native byte order:
+
+     obj      double[n+1]   objective coefficients, [0] the constant term
+     rows     int[m], double[m], double[m]    types, lower and upper bounds
+     cols     int[n], int[n], double[n], double[n]
+                            types, kinds, lower and upper bounds
+     matrix   int[m+1], int[nnz+1], double[nnz+1]
+                            the rows' start offsets, then their column
+                            indices and values from [1] on, as GLPK's
+                            1-based arrays, so that row i is held in
+                            [ptr[i-1]+1 .. ptr[i]]
+     names    char[names_len]    optional: the problem, objective, row and
+                            column names, each terminated by a NUL
+     basis    int[m], int[n]     optional: the row and column statuses
+     solution               optional: the values of the last solver's
+                            solution, in solution_len bytes laid out as
+                            below from the section's start
+
+   The solution section is laid out in the same way:
+
+     stat     int[2]        the primal and dual statuses of a basic
+                            solution, else the solution's status
+     obj      double        the objective value
+     stat     int[m], int[n]     a basic solution's row and column
+                            statuses
+     prim     double[m], double[m], double[n], double[n]
+                            the rows' primal and dual values, then the
+                            columns', the duals unused for a MIP solution
+
+   GLPK can only assign a solution through its readers of solution files,
+   so when loading, one is generated from these with 17 significant
+   digits, enough for every value to read back exactly.
+
+   Readers reject snapshots of another version or byte order. */
+
+#define SNAPSHOT_VERSION 2
+
+/* The optional sections. */
+#define SNAPSHOT_NAMES    1
+#define SNAPSHOT_BASIS    2
+#define SNAPSHOT_SOLUTION 4
+#define SNAPSHOT_ALL (SNAPSHOT_NAMES | SNAPSHOT_BASIS | SNAPSHOT_SOLUTION)
+
+typedef struct {
+	LPXObject *py_lp; // The problem, borrowed.
+	int sections; // The SNAPSHOT_* sections it holds.
+	size_t names_len;
+	size_t size; // The snapshot's size in bytes.
+} Snapshot;
+
+/* Prepare a snapshot of the problem with the requested optional sections,
+   of those it has, computing its size. Returns 0 with an exception set on
+   failure, 1 on success. */
+int Snapshot_Prepare(Snapshot *s, LPXObject *py_lp, int sections);
+/* Write the prepared snapshot into a buffer of s->size bytes, aligned to 8
+   bytes. This does not need the GIL. */
+void Snapshot_Fill(const Snapshot *s, void *buf);
+/* Load a snapshot of len bytes into the problem, which must be empty.
+   Returns 0 with an exception set if it is not a valid snapshot, in which
+   case the problem may be partially loaded, 1 on success. */
+int Snapshot_Load(LPXObject *py_lp, const void *buf, size_t len);
+
+/* Return a new bytes object holding a snapshot of the problem with the
+   requested optional sections, or NULL with an exception set. */
+PyObject *Snapshot_ToBytes(LPXObject *py_lp, int sections);
+
+/* The implementations of LPX.save_snapshot and LPX.load_snapshot. */
+PyObject *Snapshot_SaveFile(LPXObject *py_lp, PyObject *args,
+			    PyObject *kwds);
+PyObject *Snapshot_LoadFile(PyTypeObject *type, PyObject *args,
+			    PyObject *kwds);
+/* The implementations of LPX.to_shared_memory, LPX.from_shared_memory,
+   LPX.solution_to_shared_memory and LPX.solution_from_shared_memory,
+   which exchange snapshots, and solutions alone, through segments of
+   multiprocessing.shared_memory. */
+PyObject *Snapshot_ToSharedMemory(LPXObject *py_lp, PyObject *args,
+				  PyObject *kwds);
+PyObject *Snapshot_FromSharedMemory(PyTypeObject *type, PyObject *args,
+				    PyObject *kwds);
+PyObject *Snapshot_SolutionToSharedMemory(LPXObject *py_lp,
+					  PyObject *noargs);
+PyObject *Snapshot_SolutionFromSharedMemory(LPXObject *py_lp,
+					    PyObject *args);
+
+#endif // _SNAPSHOT_H
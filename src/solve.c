@@ -0,0 +1,1318 @@
+/**************************************************************************
+Copyright (C) 2007, 2008 Thomas Finley, tfinley@gmail.com
+
+This file is part of PyGLPK.
+
+PyGLPK is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+PyGLPK is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with PyGLPK.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#include "2to3.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include "solve.h"
+#include "tree.h"
+#include "cancel.h"
+#include "environment.h"
+#include "util.h"
+
+/**************** SOLVE TASKS **************/
+
+/*
+ * Neither simplex solver can be interrupted, but both resume from the
+ * basis they leave behind upon reaching their iteration limit. So to stop
+ * upon request, they run in slices of iterations, and stopped is checked
+ * between slices. The user's iteration and time limits apply to the solve
+ * as a whole.
+ *
+ * Each call costs a fixed setup, rebuilding the working problem and
+ * refactorizing the basis, besides its iterations. Both are fitted from
+ * the last two slices of different sizes, and the slice is sized so that
+ * its iterations take about SOLVE_SLICE_MS, or four times the setup if
+ * that is more, so that a costly setup grows the slice rather than
+ * shrinking it. It changes by at most a factor of two at a time, and
+ * never drops below SOLVE_SLICE_MIN iterations.
+ */
+#define SOLVE_SLICE_MS 10.0
+#define SOLVE_SLICE_MIN 100
+
+static int solve_simplex(glp_prob *lp, const glp_smcp *parm, int exact,
+			 int (*stopped)(void*), void *info)
+{
+	glp_smcp cp = *parm;
+	double start, began, took, last_took = 0.0, per_it, setup, want;
+	int r, slice = SOLVE_SLICE_MIN, last = 0, left = parm->it_lim;
+
+	if (stopped == NULL)
+		return exact ? glp_exact(lp, &cp) : glp_simplex(lp, &cp);
+	// The presolver's solution is only recovered once it is optimal.
+	cp.presolve = GLP_OFF;
+	began = glp_time();
+	for (;;) {
+		if (stopped(info))
+			return GLP_ESTOP;
+		cp.it_lim = left < slice ? left : slice;
+		if (parm->tm_lim < INT_MAX) {
+			cp.tm_lim = parm->tm_lim - (int)(glp_time() - began);
+			cp.tm_lim = cp.tm_lim > 0 ? cp.tm_lim : 0;
+		}
+		start = glp_time();
+		r = exact ? glp_exact(lp, &cp) : glp_simplex(lp, &cp);
+		if (r != GLP_EITLIM || cp.it_lim == left)
+			return r;
+		if (left < INT_MAX)
+			left -= cp.it_lim;
+		took = glp_time() - start;
+		// Until two sizes are seen, or if the timer is too coarse to
+		// tell them apart, iterations are taken to be cheap.
+		want = 2.0 * slice;
+		if (last && last != cp.it_lim) {
+			per_it = (took - last_took) / (cp.it_lim - last);
+			if (per_it > 0.0) {
+				setup = took - per_it * cp.it_lim;
+				setup = setup > 0.0 ? setup : 0.0;
+				want = (setup * 4 > SOLVE_SLICE_MS ?
+					setup * 4 : SOLVE_SLICE_MS) / per_it;
+			}
+		}
+		last = cp.it_lim;
+		last_took = took;
+		if (want > 2.0 * slice)
+			want = 2.0 * slice;
+		else if (want < 0.5 * slice)
+			want = 0.5 * slice;
+		if (want > INT_MAX / 2)
+			want = INT_MAX / 2;
+		slice = want > SOLVE_SLICE_MIN ? (int)want : SOLVE_SLICE_MIN;
+	}
+}
+
+static int solve_token_stopped(void *token)
+{
+	return Cancel_Check((PyObject*)token);
+}
+
+int Solve_Simplex(glp_prob *lp, const glp_smcp *parm, int exact,
+		  PyObject *cancel)
+{
+	return solve_simplex(lp, parm, exact,
+			     cancel ? solve_token_stopped : NULL, cancel);
+}
+
+int Solve_ParseMethod(PyObject *method)
+{
+	const char *name;
+	if (method == NULL || method == Py_None)
+		return SOLVE_SIMPLEX;
+	if ((name = PyString_AsString(method)) == NULL)
+		return -1;
+	if (!strcmp(name, "simplex"))
+		return SOLVE_SIMPLEX;
+	if (!strcmp(name, "exact"))
+		return SOLVE_EXACT;
+	if (!strcmp(name, "interior"))
+		return SOLVE_INTERIOR;
+	if (!strcmp(name, "integer"))
+		return SOLVE_INTEGER;
+	PyErr_Format(PyExc_ValueError, "method '%s' unrecognized (simplex, "
+		     "exact, interior and integer are valid values)", name);
+	return -1;
+}
+
+int Solve_ParseParams(SolveTask *task, PyObject *kwds)
+{
+	static char *kwlist[] = {"nogil", "cancel", NULL};
+	PyObject *args, *callback = NULL;
+	int nogil = 0, ok = 0;
+
+	// The nogil argument is accepted, but these never hold the GIL.
+	if ((args = PyTuple_New(0)) == NULL)
+		return 0;
+	switch (task->method) {
+	case SOLVE_SIMPLEX:
+	case SOLVE_EXACT:
+		ok = LPX_ParseSmcp(args, kwds, &task->smcp, &task->cancel,
+				   &nogil);
+		break;
+	case SOLVE_INTERIOR:
+		ok = PyArg_ParseTupleAndKeywords(args, kwds, "|iO&", kwlist,
+						 &nogil, Cancel_Converter,
+						 &task->cancel);
+		break;
+	case SOLVE_INTEGER:
+		ok = LPX_ParseIocp(args, kwds, &task->iocp, &callback,
+				   &task->cancel, &nogil, &task->search);
+		if (ok && callback != NULL && callback != Py_None) {
+			// A C callback needs no GIL, so may run on any thread.
+			ok = LPX_MipCallbackCapsule(callback, &task->iocp);
+			if (ok == 0)
+				PyErr_SetString(PyExc_ValueError, "Python callbacks "
+						"cannot be used when solving on "
+						"other threads");
+			ok = ok > 0;
+			task->names = ok;
+		}
+		break;
+	}
+	Py_DECREF(args);
+	return ok;
+}
+
+/* As LPX.integer, check the problem can be solved with the parameters. */
+static int solve_check_integer(SolveTask *task, LPXObject *py_lp)
+{
+	if (task->method == SOLVE_INTEGER && task->iocp.presolve == GLP_OFF &&
+	    glp_get_status(py_lp->lp) != GLP_OPT) {
+		PyErr_SetString(PyExc_RuntimeError, "integer solver without presolve requires existing optimal basic solution");
+		return 0;
+	}
+	return 1;
+}
+
+int Solve_Begin(SolveTask *task, LPXObject *py_lp)
+{
+	if (!solve_check_integer(task, py_lp))
+		return 0;
+	if (!LPX_BeginSolve(py_lp))
+		return 0;
+	task->py_lp = py_lp;
+	task->retval = 0;
+	task->ran = 0;
+	task->copy = NULL;
+	return 1;
+}
+
+/*
+ * The tasks of a race share this. The first task to finish successfully
+ * wins, or else the last to finish. Integer solver tasks are stopped
+ * through their callback once there is a winner, and simplex ones after
+ * their slice, so a race may signal once every task has copied the
+ * problem, and once its winner is done, while the losers wind down.
+ */
+struct solve_race {
+	SolveTask *tasks;
+	PyThread_type_lock mutex;
+	int ntasks, copied, finished;
+	int winner; // The index of the winning task, or -1.
+	volatile int stop; // Set once there is a winner.
+	PyThread_type_lock all_copied, decided; // Released if not NULL.
+};
+
+static void solve_race_copied(struct solve_race *race)
+{
+	int all;
+	PyThread_acquire_lock(race->mutex, WAIT_LOCK);
+	all = ++race->copied == race->ntasks;
+	PyThread_release_lock(race->mutex);
+	if (all && race->all_copied)
+		PyThread_release_lock(race->all_copied);
+}
+
+static int solve_race_claim(SolveTask *task)
+{
+	struct solve_race *race = task->race;
+	int r = task->retval, won, last;
+	PyThread_acquire_lock(race->mutex, WAIT_LOCK);
+	last = ++race->finished == race->ntasks;
+	won = race->winner < 0 && (last || task->cancelled || (task->ran &&
+		(!r || r == GLP_EMIPGAP || r == GLP_ENOPFS || r == GLP_ENODFS)));
+	if (won) {
+		race->winner = (int)(task - race->tasks);
+		race->stop = 1;
+	}
+	PyThread_release_lock(race->mutex);
+	return won;
+}
+
+static int solve_task_stopped(void *info)
+{
+	SolveTask *task = (SolveTask*)info;
+	return (task->stop != NULL && *task->stop) || Cancel_Check(task->cancel);
+}
+
+static void solve_task_callback(glp_tree *tree, void *info)
+{
+	SolveTask *task = (SolveTask*)info;
+	if (solve_task_stopped(task)) {
+		glp_ios_terminate(tree);
+		return;
+	}
+	task->acted = 0;
+	if (task->cb_func != NULL)
+		task->cb_func(tree, task->cb_info);
+	Search_Callback(&task->search, tree, task->acted);
+}
+
+/*
+ * With the GIL held, copy a finished task's solved copy over its problem,
+ * which keeps every solution value exactly, and let the task's thread,
+ * which owns the copy, free it.
+ */
+static void solve_hand_back(SolveTask *task)
+{
+	glp_copy_prob(task->py_lp->lp, task->copy, GLP_ON);
+	task->copy = NULL;
+	PyThread_release_lock(task->handed);
+}
+
+/* Let the task's thread free its copy without handing it back. */
+static void solve_discard(SolveTask *task)
+{
+	if (task->copy == NULL)
+		return;
+	task->copy = NULL;
+	task->ran = 0;
+	PyThread_release_lock(task->handed);
+}
+
+void Solve_Run(SolveTask *task)
+{
+	glp_prob *copy = glp_create_prob();
+	PyThread_type_lock handed = task->handed;
+	int (*stopped)(void*) = NULL;
+	int r, won, kept;
+
+	// Always with names, as the copy is later copied over the problem.
+	glp_copy_prob(copy, task->py_lp->lp, GLP_ON);
+	// Lookups by name from other threads must not build the index.
+	if (task->names)
+		glp_create_index(copy);
+	if (task->race != NULL)
+		solve_race_copied(task->race);
+	if (task->cancel != NULL || task->stop != NULL)
+		stopped = solve_task_stopped;
+	switch (task->method) {
+	case SOLVE_SIMPLEX:
+		r = task->retval = solve_simplex(copy, &task->smcp, 0, stopped,
+						 task);
+		task->ran = r!=GLP_EBADB && r!=GLP_ESING && r!=GLP_ECOND && r!=GLP_EBOUND && r!=GLP_EFAIL;
+		break;
+	case SOLVE_EXACT:
+		task->retval = solve_simplex(copy, &task->smcp, 1, stopped, task);
+		task->ran = !task->retval;
+		break;
+	case SOLVE_INTERIOR:
+		// This cannot be interrupted, so is only stopped before starting.
+		if (stopped && stopped(task))
+			task->retval = GLP_ESTOP;
+		else
+			task->retval = glp_interior(copy, NULL);
+		task->ran = !task->retval;
+		break;
+	case SOLVE_INTEGER:
+		if ((stopped || Search_Active(&task->search)) &&
+		    task->iocp.cb_func != solve_task_callback) {
+			// Any callback is run by this one.
+			task->cb_func = task->iocp.cb_func;
+			task->cb_info = task->iocp.cb_info;
+			task->iocp.cb_func = solve_task_callback;
+			task->iocp.cb_info = task;
+		}
+		Search_Prepare(&task->search, &task->iocp);
+		r = task->retval = glp_intopt(copy, &task->iocp);
+		Search_Clear(&task->search);
+		task->ran = r!=GLP_EBADB && r!=GLP_ESING && r!=GLP_ECOND && r!=GLP_EBOUND && r!=GLP_EFAIL;
+		break;
+	}
+	task->cancelled = task->retval == GLP_ESTOP && Cancel_Check(task->cancel);
+	// Every task of a race claims it, but only the winner hands back.
+	won = task->race == NULL || solve_race_claim(task);
+	if (!won)
+		task->ran = 0;
+	// The caller may take the task over once told, so decide beforehand.
+	kept = task->ran && handed != NULL;
+	task->copy = kept ? copy : NULL;
+	if (task->finished != NULL)
+		task->finished(task, task->finished_info);
+	if (kept)
+		PyThread_acquire_lock(handed, WAIT_LOCK);
+	glp_delete_prob(copy);
+}
+
+PyObject *Solve_Finish(SolveTask *task)
+{
+	LPXObject *py_lp = task->py_lp;
+	py_lp->solving = 0;
+	Environment_FlushTerm();
+	if (task->copy != NULL)
+		solve_hand_back(task);
+	if (!task->ran)
+		return Cancel_Message(task->retval, task->cancelled);
+	switch (task->method) {
+	case SOLVE_INTERIOR:
+		py_lp->last_solver = 1;
+		break;
+	case SOLVE_INTEGER:
+		py_lp->last_solver = 2;
+		break;
+	default:
+		py_lp->last_solver = 0;
+		break;
+	}
+	return Cancel_Message(task->retval, task->cancelled);
+}
+
+/*
+ * If GLPK was built without thread local storage, all threads share one
+ * environment, and running solvers on other threads would corrupt it. A
+ * thread that has not used GLPK sees no allocated memory in its own
+ * environment, whereas the shared one holds at least the problems we are
+ * about to solve, so ask a fresh thread once.
+ */
+static int solve_reentrant = -1;
+
+struct solve_probe {
+	PyThread_type_lock done;
+	int reentrant;
+};
+
+static void solve_probe(void *arg)
+{
+	struct solve_probe *probe = (struct solve_probe*)arg;
+	int count;
+	glp_mem_usage(&count, NULL, NULL, NULL);
+	probe->reentrant = count == 0;
+	if (probe->reentrant)
+		glp_free_env();
+	PyThread_release_lock(probe->done);
+}
+
+int Solve_CheckReentrant(void)
+{
+	struct solve_probe probe;
+	if (solve_reentrant < 0) {
+		if ((probe.done = PyThread_allocate_lock()) == NULL) {
+			PyErr_NoMemory();
+			return 0;
+		}
+		PyThread_acquire_lock(probe.done, WAIT_LOCK);
+		if (PyThread_start_new_thread(solve_probe, &probe) ==
+		    PYTHREAD_INVALID_THREAD_ID) {
+			PyThread_free_lock(probe.done);
+			PyErr_SetString(PyExc_RuntimeError,
+					"can't start new thread");
+			return 0;
+		}
+		Py_BEGIN_ALLOW_THREADS
+		PyThread_acquire_lock(probe.done, WAIT_LOCK);
+		Py_END_ALLOW_THREADS
+		PyThread_free_lock(probe.done);
+		solve_reentrant = probe.reentrant;
+	}
+	if (!solve_reentrant) {
+		PyErr_SetString(PyExc_RuntimeError, "GLPK was built without "
+				"thread local environments, so cannot solve on "
+				"other threads");
+		return 0;
+	}
+	return 1;
+}
+
+/**************** THREAD POOL **************/
+
+/*
+ * Each task finished by a worker is queued for the caller, who hands its
+ * solution back with the GIL held while the worker waits to free its copy.
+ */
+struct solve_pool {
+	SolveTask *tasks;
+	int ntasks, next, running;
+	int *finished, nfinished; // The queue of finished tasks' indices.
+	int waiting; // Whether the caller waits on ready.
+	PyThread_type_lock mutex, done, ready;
+};
+
+struct solve_worker {
+	struct solve_pool *pool;
+	PyThread_type_lock handed;
+};
+
+static void solve_pool_finished(SolveTask *task, void *info)
+{
+	struct solve_pool *pool = (struct solve_pool*)info;
+	PyThread_acquire_lock(pool->mutex, WAIT_LOCK);
+	pool->finished[pool->nfinished++] = (int)(task - pool->tasks);
+	if (pool->waiting) {
+		pool->waiting = 0;
+		PyThread_release_lock(pool->ready);
+	}
+	PyThread_release_lock(pool->mutex);
+}
+
+static void solve_worker(void *arg)
+{
+	struct solve_worker *worker = (struct solve_worker*)arg;
+	struct solve_pool *pool = worker->pool;
+	EnvironmentThread term;
+	PyGILState_STATE gstate;
+	int i, last;
+
+	gstate = PyGILState_Ensure();
+	Environment_InitThread(&term);
+	PyGILState_Release(gstate);
+	for (;;) {
+		PyThread_acquire_lock(pool->mutex, WAIT_LOCK);
+		i = pool->next < pool->ntasks ? pool->next++ : -1;
+		PyThread_release_lock(pool->mutex);
+		if (i < 0)
+			break;
+		pool->tasks[i].handed = worker->handed;
+		pool->tasks[i].finished = solve_pool_finished;
+		pool->tasks[i].finished_info = pool;
+		Solve_Run(pool->tasks + i);
+	}
+	// Every problem this thread created is gone, so drop its environment.
+	Environment_EndThread(&term);
+	glp_free_env();
+	PyThread_acquire_lock(pool->mutex, WAIT_LOCK);
+	last = --pool->running == 0;
+	PyThread_release_lock(pool->mutex);
+	if (last)
+		PyThread_release_lock(pool->done);
+}
+
+/*
+ * Run the pool's tasks upon up to nthreads workers, handing back each
+ * solution as its task finishes, and wait for the workers with the GIL
+ * released. Returns 0 with an exception set if no worker could be
+ * started.
+ */
+static int solve_pool_run(struct solve_pool *pool,
+			  struct solve_worker *workers, int nthreads)
+{
+	int i, handled, started = 0;
+
+	pool->next = pool->nfinished = pool->waiting = 0;
+	pool->finished = (int*)calloc(pool->ntasks, sizeof(int));
+	pool->mutex = PyThread_allocate_lock();
+	pool->done = PyThread_allocate_lock();
+	pool->ready = PyThread_allocate_lock();
+	if (pool->finished == NULL || pool->mutex == NULL ||
+	    pool->done == NULL || pool->ready == NULL) {
+		PyErr_NoMemory();
+		goto done;
+	}
+	for (i = 0; i < nthreads; ++i) {
+		if ((workers[i].handed = PyThread_allocate_lock()) == NULL) {
+			PyErr_NoMemory();
+			goto done;
+		}
+		PyThread_acquire_lock(workers[i].handed, WAIT_LOCK);
+	}
+	// Hold the mutex so no worker finishes before all are counted.
+	PyThread_acquire_lock(pool->done, WAIT_LOCK);
+	PyThread_acquire_lock(pool->ready, WAIT_LOCK);
+	PyThread_acquire_lock(pool->mutex, WAIT_LOCK);
+	for (i = 0; i < nthreads; ++i) {
+		workers[i].pool = pool;
+		if (PyThread_start_new_thread(solve_worker, workers + i) ==
+		    PYTHREAD_INVALID_THREAD_ID)
+			break;
+		++started;
+	}
+	pool->running = started;
+	PyThread_release_lock(pool->mutex);
+	if (started == 0) {
+		PyThread_release_lock(pool->done);
+		PyErr_SetString(PyExc_RuntimeError, "can't start new thread");
+		goto done;
+	}
+	for (handled = 0; handled < pool->ntasks; ++handled) {
+		PyThread_acquire_lock(pool->mutex, WAIT_LOCK);
+		if (handled == pool->nfinished) {
+			pool->waiting = 1;
+			PyThread_release_lock(pool->mutex);
+			Py_BEGIN_ALLOW_THREADS
+			PyThread_acquire_lock(pool->ready, WAIT_LOCK);
+			Py_END_ALLOW_THREADS
+			PyThread_acquire_lock(pool->mutex, WAIT_LOCK);
+		}
+		i = pool->finished[handled];
+		PyThread_release_lock(pool->mutex);
+		if (pool->tasks[i].copy != NULL)
+			solve_hand_back(pool->tasks + i);
+	}
+	Py_BEGIN_ALLOW_THREADS
+	PyThread_acquire_lock(pool->done, WAIT_LOCK);
+	Py_END_ALLOW_THREADS
+	PyThread_release_lock(pool->done);
+done:
+	for (i = 0; i < nthreads; ++i) {
+		if (workers[i].handed)
+			PyThread_free_lock(workers[i].handed);
+		workers[i].handed = NULL;
+	}
+	free(pool->finished);
+	if (pool->mutex)
+		PyThread_free_lock(pool->mutex);
+	if (pool->done)
+		PyThread_free_lock(pool->done);
+	if (pool->ready)
+		PyThread_free_lock(pool->ready);
+	pool->finished = NULL;
+	pool->mutex = pool->done = pool->ready = NULL;
+	return started > 0;
+}
+
+static PyObject* Solve_many(PyObject *self, PyObject *args, PyObject *kwds)
+{
+	PyObject *problems, *method = NULL, *threadsob = NULL;
+	PyObject *fast = NULL, *params = NULL, *retval = NULL, *item;
+	struct solve_pool pool;
+	struct solve_worker *workers = NULL;
+	SolveTask proto;
+	int i, n, nthreads = 0, begun = 0, failed = 0;
+
+	if (!PyArg_ParseTuple(args, "O|OO:solve_many", &problems, &method,
+			      &threadsob))
+		return NULL;
+	Py_XINCREF(method);
+	Py_XINCREF(threadsob);
+	// Everything but the method and threads go to the solver.
+	params = kwds ? PyDict_Copy(kwds) : PyDict_New();
+	if (params == NULL)
+		goto done;
+	if ((item = PyDict_GetItemString(params, "method")) != NULL) {
+		if (method) {
+			PyErr_SetString(PyExc_TypeError,
+					"method given twice to solve_many");
+			goto done;
+		}
+		Py_INCREF(method = item);
+		if (PyDict_DelItemString(params, "method"))
+			goto done;
+	}
+	if ((item = PyDict_GetItemString(params, "threads")) != NULL) {
+		if (threadsob) {
+			PyErr_SetString(PyExc_TypeError,
+					"threads given twice to solve_many");
+			goto done;
+		}
+		Py_INCREF(threadsob = item);
+		if (PyDict_DelItemString(params, "threads"))
+			goto done;
+	}
+
+	memset(&pool, 0, sizeof(pool));
+	memset(&proto, 0, sizeof(proto));
+	if ((proto.method = Solve_ParseMethod(method)) < 0 ||
+	    !Solve_ParseParams(&proto, params))
+		goto done;
+
+	if ((fast = PySequence_Fast(problems, "problems must be a sequence")) == NULL)
+		goto done;
+	n = PySequence_Fast_GET_SIZE(fast);
+	if (threadsob == NULL || threadsob == Py_None) {
+		PyObject *os = PyImport_ImportModule("os"), *cpus = NULL;
+		if (os != NULL) {
+			cpus = PyObject_CallMethod(os, "cpu_count", NULL);
+			Py_DECREF(os);
+		}
+		if (cpus == NULL)
+			goto done;
+		nthreads = cpus == Py_None ? 1 : PyInt_AsLong(cpus);
+		Py_DECREF(cpus);
+	} else {
+		nthreads = PyInt_AsLong(threadsob);
+		if (nthreads < 1 && !PyErr_Occurred())
+			PyErr_SetString(PyExc_ValueError,
+					"threads must be positive");
+	}
+	if (PyErr_Occurred())
+		goto done;
+	for (i = 0; i < n; ++i) {
+		if (!LPX_Check(PySequence_Fast_GET_ITEM(fast, i))) {
+			PyErr_Format(PyExc_TypeError, "problems must be LPX "
+				     "instances, not %.200s", Py_TYPE(
+				     PySequence_Fast_GET_ITEM(fast, i))->tp_name);
+			goto done;
+		}
+	}
+	if (n == 0) {
+		retval = PyList_New(0);
+		goto done;
+	}
+	if (nthreads > n)
+		nthreads = n;
+	if (!Solve_CheckReentrant())
+		goto done;
+
+	pool.tasks = (SolveTask*)calloc(n, sizeof(SolveTask));
+	workers = (struct solve_worker*)calloc(nthreads,
+					       sizeof(struct solve_worker));
+	if (pool.tasks == NULL || workers == NULL) {
+		PyErr_NoMemory();
+		goto done;
+	}
+	for (begun = 0; begun < n; ++begun) {
+		pool.tasks[begun] = proto;
+		if (!Solve_Begin(pool.tasks + begun, (LPXObject*)
+				 PySequence_Fast_GET_ITEM(fast, begun)))
+			goto done;
+	}
+	pool.ntasks = n;
+	if (!solve_pool_run(&pool, workers, nthreads))
+		goto done;
+
+	if ((retval = PyList_New(n)) == NULL)
+		failed = 1;
+	for (i = 0; i < n; ++i) {
+		// Finish every task, so all problems are released.
+		item = Solve_Finish(pool.tasks + i);
+		if (item == NULL)
+			failed = 1;
+		else if (retval)
+			PyList_SET_ITEM(retval, i, item);
+		else
+			Py_DECREF(item);
+	}
+	begun = 0;
+	if (failed)
+		Py_CLEAR(retval);
+done:
+	// Release any problems marked but never solved.
+	for (i = 0; i < begun; ++i)
+		pool.tasks[i].py_lp->solving = 0;
+	free(workers);
+	free(pool.tasks);
+	Py_XDECREF(fast);
+	Py_XDECREF(params);
+	Py_XDECREF(method);
+	Py_XDECREF(threadsob);
+	return retval;
+}
+
+/**************** RACING **************/
+
+PyObject *Solve_IntegerRace(LPXObject *py_lp, PyObject *args,
+			    PyObject *kwds)
+{
+	PyObject *configs, *config, *fast = NULL, *params, *message;
+	PyObject *retval = NULL;
+	struct solve_race race = {NULL, NULL, 0, 0, 0, -1, 0, NULL, NULL};
+	struct solve_pool pool;
+	struct solve_worker *workers = NULL;
+	int i, n, ok, begun = 0;
+
+	if (!PyArg_ParseTuple(args, "O:integer_race", &configs))
+		return NULL;
+	memset(&pool, 0, sizeof(pool));
+	if ((fast = PySequence_Fast(configs, "configurations must be a "
+				    "sequence")) == NULL)
+		return NULL;
+	if ((n = PySequence_Fast_GET_SIZE(fast)) == 0) {
+		PyErr_SetString(PyExc_ValueError,
+				"at least one configuration is required");
+		goto done;
+	}
+	pool.tasks = (SolveTask*)calloc(n, sizeof(SolveTask));
+	workers = (struct solve_worker*)calloc(n, sizeof(struct solve_worker));
+	if (pool.tasks == NULL || workers == NULL) {
+		PyErr_NoMemory();
+		goto done;
+	}
+	// Each configuration's arguments override those common to all.
+	for (i = 0; i < n; ++i) {
+		config = PySequence_Fast_GET_ITEM(fast, i);
+		if (!PyDict_Check(config)) {
+			PyErr_Format(PyExc_TypeError, "configurations must be "
+				     "dicts, not %.200s", Py_TYPE(config)->tp_name);
+			goto done;
+		}
+		if ((params = kwds ? PyDict_Copy(kwds) : PyDict_New()) == NULL)
+			goto done;
+		pool.tasks[i].method = SOLVE_INTEGER;
+		ok = !PyDict_Update(params, config) &&
+			Solve_ParseParams(pool.tasks + i, params) &&
+			solve_check_integer(pool.tasks + i, py_lp);
+		Py_DECREF(params);
+		if (!ok)
+			goto done;
+		// Solve_Run installs a callback stopping the losers.
+		pool.tasks[i].stop = &race.stop;
+		pool.tasks[i].race = &race;
+	}
+	if (!Solve_CheckReentrant())
+		goto done;
+	race.tasks = pool.tasks;
+	race.ntasks = n;
+	if ((race.mutex = PyThread_allocate_lock()) == NULL) {
+		PyErr_NoMemory();
+		goto done;
+	}
+	if (!Solve_Begin(pool.tasks, py_lp))
+		goto done;
+	begun = 1;
+	for (i = 0; i < n; ++i)
+		pool.tasks[i].py_lp = py_lp;
+	pool.ntasks = n;
+	if (!solve_pool_run(&pool, workers, n))
+		goto done;
+
+	begun = 0;
+	if ((message = Solve_Finish(pool.tasks + race.winner)) != NULL)
+		retval = Py_BuildValue("Ni", message, race.winner);
+done:
+	if (begun)
+		py_lp->solving = 0;
+	if (race.mutex)
+		PyThread_free_lock(race.mutex);
+	free(workers);
+	free(pool.tasks);
+	Py_XDECREF(fast);
+	return retval;
+}
+
+/*
+ * A concurrent solve hands back once its winner is done, and then waits
+ * for the losers. The simplex losers stop after their current slice of
+ * iterations, but the interior point solver gives no means to stop, so an
+ * interior loser is waited for until it finishes: no thread may outlive
+ * the call, as it could then still be running at interpreter shutdown.
+ */
+struct solve_concurrent {
+	struct solve_race race; // First, so a task's race leads here.
+	PyThread_type_lock handed; // Waited on by the winner alone.
+	PyThread_type_lock exited; // Released once every thread is done.
+	int running; // The threads left, counted under the race's mutex.
+};
+
+static void solve_concurrent_free(struct solve_concurrent *c)
+{
+	PyThread_free_lock(c->race.mutex);
+	if (c->race.all_copied)
+		PyThread_free_lock(c->race.all_copied);
+	if (c->race.decided)
+		PyThread_free_lock(c->race.decided);
+	if (c->handed)
+		PyThread_free_lock(c->handed);
+	if (c->exited)
+		PyThread_free_lock(c->exited);
+	free(c->race.tasks);
+	free(c);
+}
+
+/* Tell the caller once the winner's copy is kept for it. */
+static void solve_concurrent_finished(SolveTask *task, void *info)
+{
+	struct solve_race *race = task->race;
+	if (race->winner == (int)(task - race->tasks))
+		PyThread_release_lock(race->decided);
+}
+
+static void solve_concurrent_run(void *arg)
+{
+	SolveTask *task = (SolveTask*)arg;
+	struct solve_concurrent *c = (struct solve_concurrent*)task->race;
+	EnvironmentThread term;
+	PyGILState_STATE gstate;
+	int last;
+
+	gstate = PyGILState_Ensure();
+	Environment_InitThread(&term);
+	PyGILState_Release(gstate);
+	Solve_Run(task);
+	Environment_EndThread(&term);
+	glp_free_env();
+	PyThread_acquire_lock(c->race.mutex, WAIT_LOCK);
+	last = --c->running == 0;
+	PyThread_release_lock(c->race.mutex);
+	if (last)
+		PyThread_release_lock(c->exited);
+}
+
+PyObject *Solve_Concurrent(LPXObject *py_lp, PyObject *args, PyObject *kwds)
+{
+	static const char *names[] = {"primal", "dual", "dualp", "interior"};
+	static const int meths[] = {GLP_PRIMAL, GLP_DUAL, GLP_DUALP, 0};
+	PyObject *methods = NULL, *fast = NULL, *params = NULL, *empty = NULL;
+	PyObject *item, *message, *retval = NULL, *cancel = NULL;
+	struct solve_concurrent *c = NULL;
+	glp_smcp smcp;
+	const char *name;
+	int i, j, n, nogil = 0, begun = 0, started = 0;
+
+	if (!PyArg_ParseTuple(args, "|O:solve_concurrent", &methods))
+		return NULL;
+	Py_XINCREF(methods);
+	// Everything but the methods goes to the simplex solver.
+	params = kwds ? PyDict_Copy(kwds) : PyDict_New();
+	if (params == NULL)
+		goto done;
+	if ((item = PyDict_GetItemString(params, "methods")) != NULL) {
+		if (methods) {
+			PyErr_SetString(PyExc_TypeError,
+					"methods given twice to solve_concurrent");
+			goto done;
+		}
+		Py_INCREF(methods = item);
+		if (PyDict_DelItemString(params, "methods"))
+			goto done;
+	}
+	if ((empty = PyTuple_New(0)) == NULL ||
+	    !LPX_ParseSmcp(empty, params, &smcp, &cancel, &nogil))
+		goto done;
+	if (methods == NULL)
+		fast = Py_BuildValue("(ss)", "primal", "dual");
+	else
+		fast = PySequence_Fast(methods, "methods must be a sequence");
+	if (fast == NULL)
+		goto done;
+	if ((n = PySequence_Fast_GET_SIZE(fast)) == 0) {
+		PyErr_SetString(PyExc_ValueError,
+				"at least one method is required");
+		goto done;
+	}
+
+	if ((c = (struct solve_concurrent*)calloc(1, sizeof(*c))) == NULL ||
+	    (c->race.tasks = (SolveTask*)calloc(n, sizeof(SolveTask))) == NULL ||
+	    (c->race.mutex = PyThread_allocate_lock()) == NULL) {
+		if (c)
+			free(c->race.tasks);
+		free(c);
+		c = NULL;
+		PyErr_NoMemory();
+		goto done;
+	}
+	c->race.winner = -1;
+	c->race.all_copied = PyThread_allocate_lock();
+	c->race.decided = PyThread_allocate_lock();
+	c->handed = PyThread_allocate_lock();
+	c->exited = PyThread_allocate_lock();
+	if (!c->race.all_copied || !c->race.decided || !c->handed ||
+	    !c->exited) {
+		PyErr_NoMemory();
+		goto done;
+	}
+	for (i = 0; i < n; ++i) {
+		SolveTask *task = c->race.tasks + i;
+		if ((name = PyString_AsString(PySequence_Fast_GET_ITEM(fast, i)))
+		    == NULL)
+			goto done;
+		for (j = 0; j < 4 && strcmp(name, names[j]); ++j);
+		if (j == 4) {
+			PyErr_Format(PyExc_ValueError, "method '%s' unrecognized "
+				     "(primal, dual, dualp and interior are valid "
+				     "values)", name);
+			goto done;
+		}
+		task->method = meths[j] ? SOLVE_SIMPLEX : SOLVE_INTERIOR;
+		task->smcp = smcp;
+		task->smcp.meth = meths[j];
+		task->cancel = cancel;
+		task->stop = &c->race.stop;
+		task->race = &c->race;
+		task->handed = c->handed;
+		task->finished = solve_concurrent_finished;
+	}
+	if (!Solve_CheckReentrant())
+		goto done;
+	if (!Solve_Begin(c->race.tasks, py_lp))
+		goto done;
+	begun = 1;
+	for (i = 0; i < n; ++i)
+		c->race.tasks[i].py_lp = py_lp;
+
+	// Hold the mutex so no thread copies or finishes before all are counted.
+	PyThread_acquire_lock(c->race.all_copied, WAIT_LOCK);
+	PyThread_acquire_lock(c->race.decided, WAIT_LOCK);
+	PyThread_acquire_lock(c->handed, WAIT_LOCK);
+	PyThread_acquire_lock(c->exited, WAIT_LOCK);
+	PyThread_acquire_lock(c->race.mutex, WAIT_LOCK);
+	for (started = 0; started < n; ++started) {
+		if (PyThread_start_new_thread(solve_concurrent_run,
+					      c->race.tasks + started) ==
+		    PYTHREAD_INVALID_THREAD_ID)
+			break;
+	}
+	c->race.ntasks = c->running = started;
+	PyThread_release_lock(c->race.mutex);
+	if (started == 0) {
+		PyErr_SetString(PyExc_RuntimeError, "can't start new thread");
+		goto done;
+	}
+	// The problem may be changed once no thread reads it any more.
+	Py_BEGIN_ALLOW_THREADS
+	PyThread_acquire_lock(c->race.all_copied, WAIT_LOCK);
+	PyThread_acquire_lock(c->race.decided, WAIT_LOCK);
+	Py_END_ALLOW_THREADS
+
+	begun = 0;
+	if ((message = Solve_Finish(c->race.tasks + c->race.winner)) != NULL)
+		retval = Py_BuildValue("NO", message, PySequence_Fast_GET_ITEM(
+					       fast, c->race.winner));
+	// The winner only exits once handed back, so wait for every thread now.
+	Py_BEGIN_ALLOW_THREADS
+	PyThread_acquire_lock(c->exited, WAIT_LOCK);
+	Py_END_ALLOW_THREADS
+done:
+	if (begun)
+		py_lp->solving = 0;
+	if (c)
+		solve_concurrent_free(c);
+	Py_XDECREF(methods);
+	Py_XDECREF(params);
+	Py_XDECREF(empty);
+	Py_XDECREF(fast);
+	return retval;
+}
+
+/**************** ASYNCHRONOUS SOLVES **************/
+
+/*
+ * An asynchronous solve runs its task upon a thread of its own, and then
+ * resolves an asyncio future through the loop's call_soon_threadsafe. The
+ * integer solver's callbacks are likewise run upon the loop's thread, with
+ * the solver waiting for each to return. The state is owned by a capsule,
+ * referenced by the thread and by the functions handed to the loop.
+ */
+#define SOLVE_ASYNC "glpk.solve_async"
+
+struct solve_async {
+	SolveTask task;
+	PyObject *capsule; // Borrowed, as the capsule owns this.
+	PyObject *loop, *future;
+	LPXMipCallback cb; // The callback's methods, run upon the loop.
+	glp_tree *tree; // The tree to run one with.
+	LPXObject *tree_lp; // Lent the solver's copy during each call.
+	PyObject *exc_type, *exc_value, *exc_tb; // The first callback error.
+	PyThread_type_lock called; // Released when the method has run.
+	PyObject *capsule_cb; // A C callback, run upon the solving thread.
+	volatile int cancelled; // Set once the future is done.
+	PyThread_type_lock handed; // Released once the solution is back.
+};
+
+static void solve_async_free(PyObject *capsule)
+{
+	struct solve_async *a = (struct solve_async*)
+		PyCapsule_GetPointer(capsule, SOLVE_ASYNC);
+	Py_XDECREF(a->task.py_lp);
+	Py_XDECREF(a->task.cancel);
+	Py_XDECREF(a->loop);
+	Py_XDECREF(a->future);
+	LPX_MipCallbackClear(&a->cb);
+	Py_XDECREF(a->tree_lp);
+	Py_XDECREF(a->capsule_cb);
+	Py_XDECREF(a->exc_type);
+	Py_XDECREF(a->exc_value);
+	Py_XDECREF(a->exc_tb);
+	if (a->called)
+		PyThread_free_lock(a->called);
+	if (a->handed)
+		PyThread_free_lock(a->handed);
+	free(a);
+}
+
+/* Keep the first error raised by a callback for the future. */
+static void solve_async_keep_error(struct solve_async *a)
+{
+	if (a->exc_type == NULL)
+		PyErr_Fetch(&a->exc_type, &a->exc_value, &a->exc_tb);
+	else
+		PyErr_Clear();
+}
+
+/* Schedule one of the functions below upon the loop. 0 on failure. */
+static int solve_async_schedule(struct solve_async *a, PyMethodDef *def)
+{
+	PyObject *func, *r = NULL;
+	if ((func = PyCFunction_New(def, a->capsule)) != NULL) {
+		r = PyObject_CallMethod(a->loop, "call_soon_threadsafe", "O",
+					func);
+		Py_DECREF(func);
+	}
+	Py_XDECREF(r);
+	return r != NULL;
+}
+
+/* Upon the loop, run the callback method the solver waits on. */
+static PyObject* solve_async_call(PyObject *capsule, PyObject *unused)
+{
+	struct solve_async *a = (struct solve_async*)
+		PyCapsule_GetPointer(capsule, SOLVE_ASYNC);
+	if (!a->cancelled && a->exc_type == NULL) {
+		if (a->tree_lp == NULL)
+			a->tree_lp = LPX_FromLP(NULL);
+		if (a->tree_lp == NULL) {
+			glp_ios_terminate(a->tree);
+		} else {
+			// The problem belongs to the solver, and is not ours.
+			a->tree_lp->lp = glp_ios_get_prob(a->tree);
+			LPX_CallMipCallback(&a->cb, a->tree, a->tree_lp);
+			a->tree_lp->lp = NULL;
+		}
+		if (PyErr_Occurred())
+			solve_async_keep_error(a);
+	}
+	PyThread_release_lock(a->called);
+	Py_RETURN_NONE;
+}
+
+/* Upon the loop, finish the task and resolve the future. */
+static PyObject* solve_async_done(PyObject *capsule, PyObject *unused)
+{
+	struct solve_async *a = (struct solve_async*)
+		PyCapsule_GetPointer(capsule, SOLVE_ASYNC);
+	PyObject *result, *r, *type, *value, *tb;
+	int done;
+
+	result = Solve_Finish(&a->task);
+	if (a->exc_type != NULL) {
+		// As with LPX.integer, a callback's error is raised instead.
+		Py_XDECREF(result);
+		result = NULL;
+		PyErr_Restore(a->exc_type, a->exc_value, a->exc_tb);
+		a->exc_type = a->exc_value = a->exc_tb = NULL;
+	}
+	PyErr_Fetch(&type, &value, &tb);
+	r = PyObject_CallMethod(a->future, "done", NULL);
+	done = r ? PyObject_IsTrue(r) : -1;
+	Py_XDECREF(r);
+	if (done) {
+		// Cancelled, so nobody waits for the outcome.
+		r = done < 0 ? NULL : Py_None;
+		Py_XINCREF(r);
+	} else if (result != NULL) {
+		r = PyObject_CallMethod(a->future, "set_result", "O", result);
+	} else {
+		PyErr_NormalizeException(&type, &value, &tb);
+		if (tb != NULL)
+			PyException_SetTraceback(value, tb);
+		r = PyObject_CallMethod(a->future, "set_exception", "O", value);
+	}
+	Py_XDECREF(result);
+	Py_XDECREF(type);
+	Py_XDECREF(value);
+	Py_XDECREF(tb);
+	if (r == NULL)
+		return NULL;
+	Py_DECREF(r);
+	Py_RETURN_NONE;
+}
+
+/* Added to the future, so that cancelling it stops the solver. */
+static PyObject* solve_async_cancel(PyObject *capsule, PyObject *future)
+{
+	struct solve_async *a = (struct solve_async*)
+		PyCapsule_GetPointer(capsule, SOLVE_ASYNC);
+	a->cancelled = 1;
+	Py_RETURN_NONE;
+}
+
+static PyMethodDef solve_async_call_def = {"_solve_call",
+	(PyCFunction)solve_async_call, METH_NOARGS, NULL};
+static PyMethodDef solve_async_done_def = {"_solve_done",
+	(PyCFunction)solve_async_done, METH_NOARGS, NULL};
+static PyMethodDef solve_async_cancel_def = {"_solve_cancel",
+	(PyCFunction)solve_async_cancel, METH_O, NULL};
+
+/* The integer solver's callback upon the solving thread. */
+static void solve_async_callback(glp_tree *tree, void *info)
+{
+	struct solve_async *a = (struct solve_async*)info;
+	PyGILState_STATE gstate;
+	int reason = glp_ios_reason(tree);
+
+	if (solve_task_stopped(&a->task)) {
+		glp_ios_terminate(tree);
+		return;
+	}
+	if (!LPX_MipCallbackHandles(&a->cb, reason))
+		return;
+	gstate = PyGILState_Ensure();
+	a->tree = tree;
+	if (solve_async_schedule(a, &solve_async_call_def)) {
+		Py_BEGIN_ALLOW_THREADS
+		PyThread_acquire_lock(a->called, WAIT_LOCK);
+		Py_END_ALLOW_THREADS
+	} else {
+		solve_async_keep_error(a);
+		glp_ios_terminate(tree);
+	}
+	a->tree = NULL;
+	// Run by solve_task_callback, which goes on with the native search.
+	a->task.acted = LPX_MipCallbackActed(&a->cb, reason);
+	PyGILState_Release(gstate);
+}
+
+/* Upon the solving thread, have the loop hand back and finish the task. */
+static void solve_async_finished(SolveTask *task, void *info)
+{
+	struct solve_async *a = (struct solve_async*)info;
+	PyGILState_STATE gstate = PyGILState_Ensure();
+	if (!solve_async_schedule(a, &solve_async_done_def)) {
+		// The loop is closed, but the problem must still be released.
+		PyErr_WriteUnraisable(a->loop);
+		solve_discard(task);
+		Py_XDECREF(Solve_Finish(task));
+		PyErr_Clear();
+	}
+	PyGILState_Release(gstate);
+}
+
+static void solve_async_run(void *arg)
+{
+	struct solve_async *a = (struct solve_async*)arg;
+	EnvironmentThread term;
+	PyGILState_STATE gstate;
+
+	gstate = PyGILState_Ensure();
+	Environment_InitThread(&term);
+	PyGILState_Release(gstate);
+	Solve_Run(&a->task);
+	Environment_EndThread(&term);
+	glp_free_env();
+	gstate = PyGILState_Ensure();
+	Py_DECREF(a->capsule);
+	PyGILState_Release(gstate);
+}
+
+PyObject *Solve_Async(LPXObject *py_lp, int method, PyObject *args,
+		      PyObject *kwds)
+{
+	struct solve_async *a;
+	PyObject *capsule, *asyncio, *cancel = NULL, *callback = NULL, *r;
+	int nogil = 0, native;
+
+	if ((a = (struct solve_async*)calloc(1, sizeof(*a))) == NULL)
+		return PyErr_NoMemory();
+	if ((capsule = PyCapsule_New(a, SOLVE_ASYNC, solve_async_free)) == NULL) {
+		free(a);
+		return NULL;
+	}
+	a->capsule = capsule;
+	a->task.method = method;
+	if (method == SOLVE_INTEGER) {
+		// The nogil argument is accepted, but the solver never holds it.
+		if (!LPX_ParseIocp(args, kwds, &a->task.iocp, &callback,
+				   &a->task.cancel, &nogil, &a->task.search)) {
+			a->task.cancel = NULL; // Not referenced yet.
+			goto failure;
+		}
+		if (callback == Py_None)
+			callback = NULL;
+		a->task.names = callback != NULL;
+	} else if (!LPX_ParseSmcp(args, kwds, &a->task.smcp, &a->task.cancel,
+				  &nogil)) {
+		a->task.cancel = NULL;
+		goto failure;
+	}
+	Py_XINCREF(a->task.cancel);
+	a->task.stop = &a->cancelled;
+	if ((native = LPX_MipCallbackCapsule(callback, &a->task.iocp)) < 0)
+		goto failure;
+	if (native) {
+		// Solve_Run chains it after checking the future.
+		Py_INCREF(a->capsule_cb = callback);
+	} else if (method == SOLVE_INTEGER) {
+		if (!LPX_MipCallbackInit(&a->cb, callback))
+			goto failure;
+		// Its methods run upon the event loop's thread.
+		a->cb.foreign = 1;
+		a->task.iocp.cb_func = solve_async_callback;
+		a->task.iocp.cb_info = a;
+	}
+	if (!Solve_CheckReentrant())
+		goto failure;
+	if ((asyncio = PyImport_ImportModule("asyncio")) == NULL)
+		goto failure;
+	a->loop = PyObject_CallMethod(asyncio, "get_running_loop", NULL);
+	Py_DECREF(asyncio);
+	if (a->loop == NULL || (a->future = PyObject_CallMethod(
+			a->loop, "create_future", NULL)) == NULL)
+		goto failure;
+	if ((a->called = PyThread_allocate_lock()) == NULL) {
+		PyErr_NoMemory();
+		goto failure;
+	}
+	PyThread_acquire_lock(a->called, WAIT_LOCK);
+	if ((a->handed = PyThread_allocate_lock()) == NULL) {
+		PyErr_NoMemory();
+		goto failure;
+	}
+	PyThread_acquire_lock(a->handed, WAIT_LOCK);
+	a->task.handed = a->handed;
+	a->task.finished = solve_async_finished;
+	a->task.finished_info = a;
+	if (!Solve_Begin(&a->task, py_lp))
+		goto failure;
+	Py_INCREF(py_lp);
+	if ((cancel = PyCFunction_New(&solve_async_cancel_def, capsule)) == NULL ||
+	    (r = PyObject_CallMethod(a->future, "add_done_callback", "O",
+				     cancel)) == NULL) {
+		py_lp->solving = 0;
+		goto failure;
+	}
+	Py_DECREF(r);
+	// The thread holds a reference to the capsule until it is done.
+	Py_INCREF(capsule);
+	if (PyThread_start_new_thread(solve_async_run, a) ==
+	    PYTHREAD_INVALID_THREAD_ID) {
+		Py_DECREF(capsule);
+		py_lp->solving = 0;
+		// Break the cycle through the future's callback.
+		r = PyObject_CallMethod(a->future, "remove_done_callback", "O",
+					cancel);
+		Py_XDECREF(r);
+		PyErr_SetString(PyExc_RuntimeError, "can't start new thread");
+		goto failure;
+	}
+	Py_DECREF(cancel);
+	r = a->future;
+	Py_INCREF(r);
+	Py_DECREF(capsule);
+	return r;
+failure:
+	Py_XDECREF(cancel);
+	Py_DECREF(capsule);
+	return NULL;
+}
+
+/****************** MODULE FUNCTIONS ***************/
+
+PyDoc_STRVAR(solve_many_doc,
+"solve_many(problems, method='simplex', threads=None, **params)\n"
+"\n"
+"Solve a sequence of independent LPX instances on a pool of native worker\n"
+"threads, and return a list of what the corresponding solver method would\n"
+"have returned for each problem, e.g., None for a successful simplex. The\n"
+"solutions are installed in the problems, so the status, objective and\n"
+"variable values may be read from them afterwards as usual, and are\n"
+"exactly those of a direct solve.\n"
+"\n"
+"The method is one of 'simplex', 'exact', 'interior' or 'integer', and the\n"
+"params are the keyword arguments of that method of LPX, which are\n"
+"checked in the same way and apply to every problem. The integer solver\n"
+"accepts C callbacks in a PyCapsule, run upon the worker threads, but not\n"
+"Python callback objects. The number of threads defaults to the number\n"
+"of CPUs.\n"
+"\n"
+"Each worker solves a private copy of its problem, since GLPK problems\n"
+"belong to the thread that created them, and this copies each solved\n"
+"copy back over its problem as it finishes.\n"
+"The problems must not be modified by other threads until this returns.\n"
+"This requires GLPK built with thread local storage, as it is by\n"
+"default.");
+
+static PyMethodDef solve_methods[] = {
+	{"solve_many", (PyCFunction)Solve_many, METH_VARARGS|METH_KEYWORDS,
+	solve_many_doc},
+	{NULL, NULL, 0, NULL}
+};
+
+int Solve_InitModule(PyObject *module)
+{
+	return PyModule_AddFunctions(module, solve_methods);
+}
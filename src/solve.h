@@ -0,0 +1,125 @@
+/**************************************************************************
+Copyright (C) 2007, 2008 Thomas Finley, tfinley@gmail.com
+
+This file is part of PyGLPK.
+
+PyGLPK is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+PyGLPK is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with PyGLPK.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#ifndef _SOLVE_H
+#define _SOLVE_H
+
+#include <Python.h>
+#include <glpk.h>
+#include "lp.h"
+
+/* Running solvers on native threads.
+
+   GLPK keeps its memory bookkeeping in a per-thread environment, so a
+   problem must only be modified by the thread that created it.  A solve
+   task therefore never runs the solver upon the user's problem itself:
+   the worker thread solves a private copy. The copy belongs to the
+   worker's environment and the problem to the caller's, so once solved
+   the copy is kept until the caller, holding the GIL, copies it over the
+   problem with glp_copy_prob, which keeps the solution exactly as the
+   solver left it, and only then freed by the worker. */
+
+/* The solvers a task may run. */
+#define SOLVE_SIMPLEX  0
+#define SOLVE_EXACT    1
+#define SOLVE_INTERIOR 2
+#define SOLVE_INTEGER  3
+
+struct solve_race;
+
+typedef struct solve_task {
+	LPXObject *py_lp; // The problem, marked as solving until finished.
+	int method; // One of the SOLVE_* values.
+	glp_smcp smcp; // Parameters for SOLVE_SIMPLEX and SOLVE_EXACT.
+	glp_iocp iocp; // Parameters for SOLVE_INTEGER.
+	int retval; // The solver's return code.
+	unsigned int ran:1; // Whether the solver produced a solution.
+	unsigned int names:1; // Whether the copy's names are indexed.
+	unsigned int cancelled:1; // Whether the token stopped the solver.
+	PyObject *cancel; // A CancelToken, borrowed, or NULL.
+	volatile int *stop; // If set, the solver stops once it is nonzero.
+	void (*cb_func)(glp_tree*, void*); // The iocp's, if run by a stopper.
+	void *cb_info;
+	unsigned int acted:1; // Whether cb_func selected or branched itself.
+	Search search; // Parameters for SOLVE_INTEGER's native search.
+	// If set, only the first task of the race to finish hands back.
+	struct solve_race *race;
+	// Called by the worker once the task is done, and the solved copy, if
+	// any, is kept for the caller. The worker then waits for handed to be
+	// released, by Solve_Finish or the like, before freeing the copy.
+	void (*finished)(struct solve_task *task, void *info);
+	void *finished_info;
+	PyThread_type_lock handed; // Held while the copy is kept.
+	glp_prob *copy; // The solved copy, until handed back.
+} SolveTask;
+
+/* Run glp_simplex, or glp_exact if exact is set, upon the problem. If a
+   CancelToken is given, the solver runs without the presolver in slices
+   of iterations, checking the token between them, and returns GLP_ESTOP
+   if it was cancelled. This does not need the GIL. */
+int Solve_Simplex(glp_prob *lp, const glp_smcp *parm, int exact,
+		  PyObject *cancel);
+/* Map a method name ("simplex", "exact", "interior" or "integer") to one
+   of the SOLVE_* values. Returns -1 with an exception set on failure. */
+int Solve_ParseMethod(PyObject *method);
+/* Parse and check solver keyword arguments for the task's method, as
+   accepted by the corresponding LPX method, into the task. Python
+   callbacks cannot be run this way and are rejected, but C callbacks in
+   a PyCapsule are accepted. Returns 0 with an exception set on failure, 1
+   on success. */
+int Solve_ParseParams(SolveTask *task, PyObject *kwds);
+/* Prepare a task to solve the given problem with parameters already
+   parsed into it, marking the problem as solving. Returns 0 with an
+   exception set if the problem cannot be solved this way now. */
+int Solve_Begin(SolveTask *task, LPXObject *py_lp);
+/* Run the task. This does not need the GIL and may be called from any
+   thread, but the problem must not be modified meanwhile. If the solver
+   produced a solution, it returns only once the task's copy has been
+   handed back. */
+void Solve_Run(SolveTask *task);
+/* Complete a finished task with the GIL held, handing back its solution
+   if not yet done, releasing the problem, and returning what the
+   corresponding LPX method would have. */
+PyObject *Solve_Finish(SolveTask *task);
+/* Start solving the problem with the SOLVE_SIMPLEX or SOLVE_INTEGER method
+   and the arguments of the corresponding LPX method on a thread of its
+   own, returning an asyncio future of the running event loop, which
+   receives what that method would have returned. NULL on failure. */
+PyObject *Solve_Async(LPXObject *py_lp, int method, PyObject *args,
+		      PyObject *kwds);
+/* Solve the problem with the integer solver under several configurations
+   at once, each on its own thread, keeping the solution of the first to
+   succeed. The arguments are those of LPX.integer_race. */
+PyObject *Solve_IntegerRace(LPXObject *py_lp, PyObject *args,
+			    PyObject *kwds);
+/* Solve the problem with several LP methods at once, each on its own
+   thread, keeping the solution of the first to succeed, and leaving the
+   others to run to their end. The arguments are those of
+   LPX.solve_concurrent. */
+PyObject *Solve_Concurrent(LPXObject *py_lp, PyObject *args,
+			   PyObject *kwds);
+/* Returns 1 if GLPK keeps a separate environment per thread, 0 if not,
+   with an exception set, in which case solves cannot run on other
+   threads. */
+int Solve_CheckReentrant(void);
+
+/* Add the module level functions. 0 on success. */
+int Solve_InitModule(PyObject *module);
+
+#endif // _SOLVE_H
@@ -22,6 +22,8 @@ along with PyGLPK.  If not, see <http://www.gnu.org/licenses/>.
 #include "tree.h"
 #include "structmember.h"
 #include "util.h"
+#include <limits.h>
+#include <stdlib.h>
 #include <string.h>
 
 #define TREE (self->py_tree->tree)
@@ -311,6 +313,8 @@ TreeObject *Tree_New(glp_tree *tree, LPXObject *py_lp) {
   }
   t->py_lp = py_lp;
   t->selected = 0;
+  t->branched = 0;
+  t->foreign = 0;
   return t;
 }
 
@@ -329,9 +333,11 @@ static PyObject *Tree_terminate(TreeObject *self) {
 
 
 static PyObject *Tree_select(TreeObject *self, PyObject *args) {
-  TreeNodeObject *node=NULL;
+  PyObject *ob;
+  TreeNodeObject *node;
+  int subproblem, p;
   CHECKTREE;
-  if (!PyArg_ParseTuple(args, "O!", &TreeNodeType, &node)) {
+  if (!PyArg_ParseTuple(args, "O", &ob)) {
     return NULL;
   }
   if (glp_ios_reason(TREE) != GLP_ISELECT) {
@@ -343,15 +349,32 @@ static PyObject *Tree_select(TreeObject *self, PyObject *args) {
     PyErr_SetString(PyExc_RuntimeError, "function must be called only once");
     return NULL;
   }
-  if (self != node->py_tree) {
-    PyErr_SetString(PyExc_ValueError, "node did not come from this tree");
-    return NULL;
-  }
-  if (!node->active) {
-    PyErr_SetString(PyExc_ValueError, "node is not active");
+  if (PyObject_TypeCheck(ob, &TreeNodeType)) {
+    node = (TreeNodeObject*)ob;
+    if (self != node->py_tree) {
+      PyErr_SetString(PyExc_ValueError, "node did not come from this tree");
+      return NULL;
+    }
+    if (!node->active) {
+      PyErr_SetString(PyExc_ValueError, "node is not active");
+      return NULL;
+    }
+    subproblem = node->subproblem;
+  } else if (PyInt_Check(ob)) {
+    // A subproblem number, as from active_nodes(). GLPK gives no cheap
+    // test for activeness, so look for it in the active list.
+    subproblem = PyInt_AsLong(ob);
+    for (p=glp_ios_next_node(TREE, 0); p && p!=subproblem;
+	 p=glp_ios_next_node(TREE, p));
+    if (p == 0 || subproblem == 0) {
+      PyErr_SetString(PyExc_ValueError, "node is not active");
+      return NULL;
+    }
+  } else {
+    PyErr_SetString(PyExc_TypeError, "node must be a TreeNode or int");
     return NULL;
   }
-  glp_ios_select_node(TREE, node->subproblem);
+  glp_ios_select_node(TREE, subproblem);
   self->selected = 1;
   Py_RETURN_NONE;
 }
@@ -398,34 +421,73 @@ static PyObject *Tree_branchupon(TreeObject *self, PyObject *args) {
     PyErr_SetString(PyExc_RuntimeError, "cannot branch upon this column");
     return NULL;
   }
+  if (self->branched) {
+    PyErr_SetString(PyExc_RuntimeError, "function must be called only once");
+    return NULL;
+  }
   switch (select) {
   case 'D':
     glp_ios_branch_upon(TREE, j, GLP_DN_BRNCH);
-    Py_RETURN_NONE;
+    break;
   case 'U':
     glp_ios_branch_upon(TREE, j, GLP_UP_BRNCH);
-    Py_RETURN_NONE;
+    break;
   case 'N':
     glp_ios_branch_upon(TREE, j, GLP_NO_BRNCH);
-    Py_RETURN_NONE;
+    break;
   default:
     PyErr_SetString(PyExc_ValueError, "select argument must be D, U, or N");
     return NULL;
   }
+  self->branched = 1;
+  Py_RETURN_NONE;
+}
+
+/* Check that the callback was called for the reason, named phase in the
+   error message.  Returns 0 with an exception set if not. */
+static int tree_check_reason(TreeObject *self, int reason,
+			     const char *phase) {
+  if (glp_ios_reason(TREE) == reason) return 1;
+  PyErr_Format(PyExc_RuntimeError,
+	       "function may only be called during %s phase", phase);
+  return 0;
+}
+
+/* Cuts are rows of GLPK's, which must only be allocated and freed upon
+   the solver's own thread. */
+static int tree_check_thread(TreeObject *self) {
+  if (!self->foreign) return 1;
+  PyErr_SetString(PyExc_RuntimeError, "cuts cannot be added or deleted "
+		  "from the callback of an asynchronous solve");
+  return 0;
 }
 
 static PyObject *Tree_heuristic(TreeObject *self, PyObject *arg) {
   CHECKTREE;
-  if (glp_ios_reason(TREE) != GLP_IHEUR) {
-    PyErr_SetString(PyExc_RuntimeError,
-		    "function may only be called during heur phase");
-    return NULL;
-  }
+  if (!tree_check_reason(self, GLP_IHEUR, "heur")) return NULL;
   int i, notaccepted, numcols = glp_get_num_cols(LP);
+  double *x, *copy;
+  Py_buffer view;
+  // A buffer of doubles is handed to GLPK as it is.
+  if (PyObject_CheckBuffer(arg)) {
+    if (!util_buffer_get(arg, "values", &view)) return NULL;
+    if (util_buffer_len(&view) < numcols) {
+      PyErr_Format(PyExc_ValueError, "buffer had only %zd items, but %d "
+		   "required", util_buffer_len(&view), numcols);
+      PyBuffer_Release(&view);
+      return NULL;
+    }
+    x = util_buffer_doubles(&view, "values", &copy);
+    if (x) notaccepted = glp_ios_heur_sol(TREE, x-1);
+    free(copy);
+    PyBuffer_Release(&view);
+    if (x == NULL) return NULL;
+    if (notaccepted) Py_RETURN_FALSE; else Py_RETURN_TRUE;
+  }
   // Try to get an iterator.
   arg = PyObject_GetIter(arg);
   if (arg==NULL) return NULL;
-  double *x = calloc(numcols, sizeof(double));
+  x = calloc(numcols, sizeof(double));
   for (i=0; i<numcols; ++i) {
     PyObject *item = PyIter_Next(arg);
     if (item==NULL) {
@@ -439,13 +501,15 @@ static PyObject *Tree_heuristic(TreeObject *self, PyObject *arg) {
       return NULL;
     }
     x[i] = PyFloat_AsDouble(item);
-    Py_DECREF(item);
     if (PyErr_Occurred()) {
       free(x);
       Py_DECREF(arg);
-      PyErr_SetString(PyExc_TypeError, "iterator must return floats");
+      PyErr_Format(PyExc_TypeError, "iterator must return floats, not "
+		   "%.200s", Py_TYPE(item)->tp_name);
+      Py_DECREF(item);
       return NULL;
     }
+    Py_DECREF(item);
   }
   Py_DECREF(arg);
   notaccepted = glp_ios_heur_sol(TREE, x-1);
@@ -453,6 +517,261 @@ static PyObject *Tree_heuristic(TreeObject *self, PyObject *arg) {
   if (notaccepted) Py_RETURN_FALSE; else Py_RETURN_TRUE;
 }
 
+static PyObject *Tree_heuristics(TreeObject *self, PyObject *arg) {
+  PyObject *retval = NULL, *accepted;
+  Py_ssize_t i, npoints;
+  double *x, *copy = NULL;
+  Py_buffer view;
+  int numcols;
+  CHECKTREE;
+  if (!tree_check_reason(self, GLP_IHEUR, "heur")) return NULL;
+  if (!util_buffer_get2(arg, "points", &view)) return NULL;
+  numcols = glp_get_num_cols(LP);
+  if (view.ndim == 2 ? view.shape[1] != numcols :
+      numcols ? util_buffer_len(&view) % numcols : util_buffer_len(&view)) {
+    PyErr_Format(PyExc_ValueError, "points must hold rows of %d values",
+		 numcols);
+    goto done;
+  }
+  npoints = view.ndim == 2 ? view.shape[0] :
+    numcols ? util_buffer_len(&view) / numcols : 0;
+  if ((x = util_buffer_doubles(&view, "points", &copy)) == NULL ||
+      (retval = PyList_New(npoints)) == NULL)
+    goto done;
+  // Each accepted point becomes the incumbent the next must improve upon.
+  for (i=0; i<npoints; ++i) {
+    accepted = glp_ios_heur_sol(TREE, x+i*numcols-1) ? Py_False : Py_True;
+    Py_INCREF(accepted);
+    PyList_SET_ITEM(retval, i, accepted);
+  }
+ done:
+  free(copy);
+  PyBuffer_Release(&view);
+  return retval;
+}
+
+static PyObject *Tree_addcuts(TreeObject *self, PyObject *args) {
+  static const char *names[] = {"indptr", "indices", "data", "rhs"};
+  PyObject *obs[4], *retval = NULL;
+  Py_buffer views[4];
+  const char *kind = "<=";
+  int *indptr = NULL, *ind = NULL, *mark = NULL;
+  double *val = NULL, *valcopy = NULL, *rhs = NULL, *rhscopy = NULL;
+  int i, j, k, n, ncuts, nviews, type, reason, row;
+  CHECKTREE;
+  if (!tree_check_thread(self)) return NULL;
+  if (!PyArg_ParseTuple(args, "OOOO|s", obs, obs+1, obs+2, obs+3, &kind))
+    return NULL;
+  if (!strcmp(kind, "<=")) type = GLP_UP;
+  else if (!strcmp(kind, ">=")) type = GLP_LO;
+  else {
+    PyErr_SetString(PyExc_ValueError, "kind must be '<=' or '>='");
+    return NULL;
+  }
+  reason = glp_ios_reason(TREE);
+  if (reason != GLP_ICUTGEN && reason != GLP_IROWGEN) {
+    PyErr_SetString(PyExc_RuntimeError, "function may only be called "
+		    "during rowgen or cutgen phase");
+    return NULL;
+  }
+  for (nviews=0; nviews<4; ++nviews)
+    if (!util_buffer_get(obs[nviews], names[nviews], views+nviews))
+      goto done;
+  if (util_buffer_len(views+1) > INT_MAX ||
+      util_buffer_len(views+3) > INT_MAX) {
+    PyErr_SetString(PyExc_OverflowError, "too many cut entries");
+    goto done;
+  }
+  ncuts = (int)util_buffer_len(views+3);
+  if (util_buffer_len(views) != ncuts+1) {
+    PyErr_SetString(PyExc_ValueError, "indptr must have one more entry "
+		    "than rhs");
+    goto done;
+  }
+  if (util_buffer_len(views+1) != util_buffer_len(views+2)) {
+    PyErr_SetString(PyExc_ValueError, "indices and data must have the "
+		    "same length");
+    goto done;
+  }
+  if ((indptr = util_buffer_ints(views, names[0], 0)) == NULL ||
+      (ind = util_buffer_ints(views+1, names[1], 1)) == NULL ||
+      (val = util_buffer_doubles(views+2, names[2], &valcopy)) == NULL ||
+      (rhs = util_buffer_doubles(views+3, names[3], &rhscopy)) == NULL)
+    goto done;
+  n = glp_get_num_cols(LP);
+  if ((mark = (int*)calloc(n+1, sizeof(int))) == NULL) {
+    PyErr_NoMemory();
+    goto done;
+  }
+  // GLPK aborts upon bad rows, so check them all before adding any.
+  if (indptr[0] != 0 || indptr[ncuts] != util_buffer_len(views+1)) {
+    PyErr_SetString(PyExc_ValueError, "indptr must start at 0 and end at "
+		    "the number of indices");
+    goto done;
+  }
+  for (i=0; i<ncuts; ++i) {
+    if (indptr[i+1] < indptr[i]) {
+      PyErr_SetString(PyExc_ValueError, "indptr must be nondecreasing");
+      goto done;
+    }
+    for (k=indptr[i]; k<indptr[i+1]; ++k) {
+      j = ind[k];
+      if (j < 1 || j > n) {
+	PyErr_Format(PyExc_IndexError, "column index %d out of range", j-1);
+	goto done;
+      }
+      if (mark[j] == i+1) {
+	PyErr_Format(PyExc_ValueError, "duplicate column index %d in cut %d",
+		     j-1, i);
+	goto done;
+      }
+      mark[j] = i+1;
+    }
+  }
+  if (reason == GLP_ICUTGEN) {
+    // Cuts go to the pool, from which GLPK adds them to the subproblem.
+    for (i=0; i<ncuts; ++i)
+      glp_ios_add_row(TREE, NULL, 0, 0, indptr[i+1]-indptr[i],
+		      ind+indptr[i]-1, val+indptr[i]-1, type, rhs[i]);
+  } else if (ncuts) {
+    // Lazy constraints are added to the problem itself.
+    row = glp_add_rows(LP, ncuts);
+    for (i=0; i<ncuts; ++i) {
+      glp_set_mat_row(LP, row+i, indptr[i+1]-indptr[i],
+		      ind+indptr[i]-1, val+indptr[i]-1);
+      glp_set_row_bnds(LP, row+i, type, rhs[i], rhs[i]);
+    }
+  }
+  retval = Py_None;
+  Py_INCREF(retval);
+ done:
+  free(indptr);
+  free(ind);
+  free(mark);
+  free(valcopy);
+  free(rhscopy);
+  for (i=0; i<nviews; ++i) PyBuffer_Release(views+i);
+  return retval;
+}
+
+/* Fill a new buffer with a value of each column, or row if the rows
+   argument is true, of the current subproblem's problem. */
+static PyObject *tree_node_values(TreeObject *self, PyObject *args,
+				  PyObject *kwds,
+				  double (*colfunc)(glp_prob*, int),
+				  double (*rowfunc)(glp_prob*, int)) {
+  static char *kwlist[] = {"rows", NULL};
+  glp_prob *lp;
+  PyObject *retval;
+  double *data;
+  int i, n, rows = 0;
+  CHECKTREE;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|i", kwlist, &rows))
+    return NULL;
+  lp = glp_ios_get_prob(TREE);
+  n = rows ? glp_get_num_rows(lp) : glp_get_num_cols(lp);
+  retval = util_new_buffer("d", n, (void**)&data);
+  if (retval == NULL) return NULL;
+  if (rows) for (i=0; i<n; ++i) data[i] = rowfunc(lp, i+1);
+  else for (i=0; i<n; ++i) data[i] = colfunc(lp, i+1);
+  return retval;
+}
+
+static PyObject *Tree_nodeprimal(TreeObject *self, PyObject *args,
+				 PyObject *kwds) {
+  return tree_node_values(self, args, kwds, glp_get_col_prim,
+			  glp_get_row_prim);
+}
+
+static PyObject *Tree_nodedual(TreeObject *self, PyObject *args,
+			       PyObject *kwds) {
+  return tree_node_values(self, args, kwds, glp_get_col_dual,
+			  glp_get_row_dual);
+}
+
+static PyObject *Tree_nodestatus(TreeObject *self, PyObject *args,
+				 PyObject *kwds) {
+  static char *kwlist[] = {"rows", NULL};
+  glp_prob *lp;
+  PyObject *retval;
+  signed char *data;
+  int i, n, rows = 0;
+  CHECKTREE;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|i", kwlist, &rows))
+    return NULL;
+  lp = glp_ios_get_prob(TREE);
+  n = rows ? glp_get_num_rows(lp) : glp_get_num_cols(lp);
+  retval = util_new_buffer("b", n, (void**)&data);
+  if (retval == NULL) return NULL;
+  if (rows) for (i=0; i<n; ++i) data[i] = glp_get_row_stat(lp, i+1);
+  else for (i=0; i<n; ++i) data[i] = glp_get_col_stat(lp, i+1);
+  return retval;
+}
+
+static PyObject *Tree_activenodes(TreeObject *self) {
+  PyObject *ids, *levels, *bounds, *parents;
+  int *id, *level, *parent, i, n, node;
+  double *bound;
+  CHECKTREE;
+  glp_ios_tree_size(TREE, &n, NULL, NULL);
+  ids = util_new_buffer("i", n, (void**)&id);
+  levels = util_new_buffer("i", n, (void**)&level);
+  bounds = util_new_buffer("d", n, (void**)&bound);
+  parents = util_new_buffer("i", n, (void**)&parent);
+  if (!ids || !levels || !bounds || !parents) {
+    Py_XDECREF(ids);
+    Py_XDECREF(levels);
+    Py_XDECREF(bounds);
+    Py_XDECREF(parents);
+    return NULL;
+  }
+  for (i=0, node=glp_ios_next_node(TREE, 0); i<n && node;
+       ++i, node=glp_ios_next_node(TREE, node)) {
+    id[i] = node;
+    level[i] = glp_ios_node_level(TREE, node);
+    bound[i] = glp_ios_node_bound(TREE, node);
+    parent[i] = glp_ios_up_node(TREE, node);
+  }
+  return Py_BuildValue("(NNNN)", ids, levels, bounds, parents);
+}
+
+static int tree_cmp_desc(const void *a, const void *b) {
+  return *(const int*)b - *(const int*)a;
+}
+
+static PyObject *Tree_delcuts(TreeObject *self, PyObject *args) {
+  PyObject *ob = Py_None;
+  Py_buffer view;
+  int *cuts, i, n, size;
+  CHECKTREE;
+  if (!PyArg_ParseTuple(args, "|O", &ob)) return NULL;
+  if (!tree_check_reason(self, GLP_ICUTGEN, "cutgen")) return NULL;
+  if (!tree_check_thread(self)) return NULL;
+  if (ob == Py_None) {
+    glp_ios_clear_pool(TREE);
+    Py_RETURN_NONE;
+  }
+  if (!util_buffer_get(ob, "cut indices", &view)) return NULL;
+  n = (int)util_buffer_len(&view);
+  cuts = util_buffer_ints(&view, "cut indices", 1);
+  PyBuffer_Release(&view);
+  if (cuts == NULL) return NULL;
+  size = glp_ios_pool_size(TREE);
+  for (i=0; i<n; ++i) {
+    if (cuts[i] < 1 || cuts[i] > size) {
+      PyErr_Format(PyExc_IndexError, "cut index %d out of range", cuts[i]-1);
+      free(cuts);
+      return NULL;
+    }
+  }
+  // Deleting a cut renumbers those after it, so delete from the last.
+  qsort(cuts, n, sizeof(int), tree_cmp_desc);
+  for (i=0; i<n; ++i)
+    if (i==0 || cuts[i]!=cuts[i-1]) glp_ios_del_row(TREE, cuts[i]);
+  free(cuts);
+  Py_RETURN_NONE;
+}
+
 /****************** GET-SET-ERS ***************/
 
 static PyObject* Tree_getreason(TreeObject *self, void *closure) {
@@ -514,6 +833,12 @@ static PyObject* Tree_getgap(TreeObject *self, void *closure) {
   return PyFloat_FromDouble(glp_ios_mip_gap(TREE));
 }
 
+static PyObject* Tree_getpoolsize(TreeObject *self, void *closure) {
+  CHECKTREE;
+  if (!tree_check_reason(self, GLP_ICUTGEN, "cutgen")) return NULL;
+  return PyInt_FromLong(glp_ios_pool_size(TREE));
+}
+
 /****************** OBJECT DEFINITION *********/
 
 int Tree_InitType(PyObject *module) {
@@ -580,6 +905,11 @@ PyDoc_STRVAR(gap_doc,
 "\n"
 );
 
+PyDoc_STRVAR(pool_size_doc,
+"The number of cuts in the cut pool. This may only be read when the reason\n"
+"member of the tree is 'cutgen'."
+);
+
 static PyGetSetDef Tree_getset[] = {
   {"reason", (getter)Tree_getreason, (setter)NULL, reason_doc, NULL},
   {"num_active", (getter)Tree_getnumactive, (setter)NULL, num_active_doc,
@@ -595,6 +925,7 @@ static PyGetSetDef Tree_getset[] = {
   {"last_node", (getter)Tree_getfirstlastnode, (setter)NULL, last_node_doc,
   glp_ios_prev_node},
   {"gap", (getter)Tree_getgap, (setter)NULL, gap_doc, NULL},
+  {"pool_size", (getter)Tree_getpoolsize, (setter)NULL, pool_size_doc, NULL},
   {NULL}
 };
 
@@ -608,7 +939,8 @@ PyDoc_STRVAR(select_doc,
 "select(node)\n"
 "\n"
 "Selects a tree node to continue search from. Note that this function should\n"
-"be called only when the reason member of the tree is 'select'."
+"be called only when the reason member of the tree is 'select'. The node is\n"
+"either a TreeNode or an active subproblem number, as from active_nodes()."
 );
 
 PyDoc_STRVAR(can_branch_doc,
@@ -641,7 +973,92 @@ PyDoc_STRVAR(heuristic_doc,
 "existing one, the solution is accepted and the problem updated. This\n"
 "function returns True or False depending on whether the solution was\n"
 "accepted or not. Note that this function should be called only when the\n"
-"reason member of the tree is 'heur'."
+"reason member of the tree is 'heur'.\n"
+"\n"
+"Values supporting the buffer protocol, e.g., array.array or NumPy arrays,\n"
+"are read directly, and a contiguous buffer of doubles is passed to the\n"
+"solver without any copy."
+);
+
+PyDoc_STRVAR(heuristics_doc,
+"heuristics(points)\n"
+"\n"
+"Provide several solutions at once, as by heuristic(), where points is a\n"
+"buffer protocol object holding one solution per row, either two\n"
+"dimensional with a column per column of the problem, or one dimensional\n"
+"with the solutions laid end to end. They are offered in order, each\n"
+"having to improve upon any accepted before it. This returns a list of\n"
+"whether each was accepted. Note that this function should be called only\n"
+"when the reason member of the tree is 'heur'."
+);
+
+PyDoc_STRVAR(add_cuts_doc,
+"add_cuts(indptr, indices, data, rhs, kind='<=')\n"
+"\n"
+"Add constraints upon the columns, given in compressed sparse row form as\n"
+"by LPX.matrix_csr(): cut i has the coefficients data[indptr[i]:\n"
+"indptr[i+1]] upon the columns with the 0-based indices at the same\n"
+"positions of indices, and rhs[i] as its right hand side. The arguments\n"
+"are buffer protocol objects, e.g., array.array or NumPy arrays, and kind\n"
+"is '<=' or '>=' for all the cuts.\n"
+"\n"
+"When the reason member of the tree is 'cutgen' the cuts are added to the\n"
+"cut pool, from which the solver adds them to the current subproblem.\n"
+"When it is 'rowgen' they are added as lazy constraints, that is, as new\n"
+"rows of the current subproblem, which its descendants inherit. Either way\n"
+"the solver removes the added rows once the search ends. It may not be\n"
+"called for other reasons, nor from the callback of LPX.integer_async(),\n"
+"which runs upon another thread than the solver, where GLPK memory must\n"
+"not be allocated; a RuntimeError is raised then."
+);
+
+PyDoc_STRVAR(del_cuts_doc,
+"del_cuts([cuts])\n"
+"\n"
+"Delete the cuts with the given 0-based indices, a buffer protocol object,\n"
+"from the cut pool, or every cut if no indices are given. Note that this\n"
+"function should be called only when the reason member of the tree is\n"
+"'cutgen', and not from the callback of LPX.integer_async(), as for\n"
+"add_cuts()."
+);
+
+PyDoc_STRVAR(node_primal_doc,
+"node_primal([rows=False])\n"
+"\n"
+"Return the primal values of the columns, or of the rows if rows is true,\n"
+"in the basic solution of the current subproblem's LP relaxation, as a\n"
+"memoryview of doubles, read straight from the solver's problem. This is\n"
+"much faster than reading them through tree.lp, and is meaningful once\n"
+"the relaxation has been solved, e.g., when the reason member of the tree\n"
+"is 'rowgen', 'heur' or 'cutgen'."
+);
+
+PyDoc_STRVAR(node_dual_doc,
+"node_dual([rows=False])\n"
+"\n"
+"Return the dual values (reduced costs) of the columns, or of the rows if\n"
+"rows is true, of the current subproblem's LP relaxation, in the same way\n"
+"as node_primal()."
+);
+
+PyDoc_STRVAR(node_status_doc,
+"node_status([rows=False])\n"
+"\n"
+"Return the basis statuses of the columns, or of the rows if rows is true,\n"
+"of the current subproblem's LP relaxation as a memoryview of signed\n"
+"bytes, holding LPX.BS, LPX.NL, LPX.NU, LPX.NF or LPX.NS as with\n"
+"LPX.get_basis()."
+);
+
+PyDoc_STRVAR(active_nodes_doc,
+"active_nodes()\n"
+"\n"
+"Return the active subproblems as a tuple of four memoryviews of the same\n"
+"length, holding in active list order the subproblem numbers (ints), their\n"
+"levels (ints), local bounds (doubles) and parent subproblem numbers\n"
+"(ints, 0 for the root), as the TreeNode attributes subproblem, level,\n"
+"bound and up would give. This reads the whole active list in one pass\n"
+"without creating any TreeNode, and select() accepts the numbers."
 );
 
 static PyMethodDef Tree_methods[] = {
@@ -650,6 +1067,17 @@ static PyMethodDef Tree_methods[] = {
   {"can_branch", (PyCFunction)Tree_canbranch, METH_VARARGS, can_branch_doc},
   {"branch_upon", (PyCFunction)Tree_branchupon, METH_VARARGS, branch_upon_doc},
   {"heuristic", (PyCFunction)Tree_heuristic, METH_O, heuristic_doc},
+  {"heuristics", (PyCFunction)Tree_heuristics, METH_O, heuristics_doc},
+  {"add_cuts", (PyCFunction)Tree_addcuts, METH_VARARGS, add_cuts_doc},
+  {"del_cuts", (PyCFunction)Tree_delcuts, METH_VARARGS, del_cuts_doc},
+  {"node_primal", (PyCFunction)Tree_nodeprimal, METH_VARARGS|METH_KEYWORDS,
+   node_primal_doc},
+  {"node_dual", (PyCFunction)Tree_nodedual, METH_VARARGS|METH_KEYWORDS,
+   node_dual_doc},
+  {"node_status", (PyCFunction)Tree_nodestatus, METH_VARARGS|METH_KEYWORDS,
+   node_status_doc},
+  {"active_nodes", (PyCFunction)Tree_activenodes, METH_NOARGS,
+   active_nodes_doc},
   {NULL}
 };
 
@@ -30,6 +30,10 @@ typedef struct {
   PyObject_HEAD
   glp_tree *tree;
   unsigned char selected:1;
+  unsigned char branched:1;
+  // Set if called on another thread than the solver's, as by
+  // LPX.integer_async, which forbids allocating GLPK memory.
+  unsigned char foreign:1;
   LPXObject *py_lp;
   PyObject *weakreflist; // Weak reference list.
 } TreeObject;
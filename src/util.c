@@ -25,6 +25,14 @@ along with PyGLPK.  If not, see <http://www.gnu.org/licenses/>.
 #include "lp.h"
 #include <string.h>
 #include <stdio.h>
+#include <limits.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef MFD_CLOEXEC
+#define UTIL_MEMFD
+#endif
+#endif
 
 int util_extract_if(PyObject *ob, PyObject *barcol,
 		    int *len, int **ind, double **val) {
@@ -257,6 +265,224 @@ int util_extract_iif(PyObject *ob, PyObject*lpobj,
   return 1;
 }
 
+/**************** BUFFER PROTOCOL HELPERS ***************/
+
+/* Classify the item format of a buffer: 'i' for signed integers, 'u' for
+   unsigned integers, 'f' for floating point, or 0 if unsupported. */
+static char buffer_kind(Py_buffer *view) {
+  const char *fmt = view->format ? view->format : "B";
+  // Byte order and size prefixes; the itemsize tells us the actual size.
+  if (*fmt=='@' || *fmt=='=' || *fmt==
+#if PY_LITTLE_ENDIAN
+      '<'
+#else
+      '>'
+#endif
+      ) fmt++;
+  if (fmt[0]==0 || fmt[1]!=0) return 0;
+  switch (fmt[0]) {
+  case 'b': case 'h': case 'i': case 'l': case 'q': case 'n':
+    return 'i';
+  case 'B': case 'H': case 'I': case 'L': case 'Q': case 'N': case '?':
+    return 'u';
+  case 'f': case 'd':
+    return 'f';
+  }
+  return 0;
+}
+
+static int buffer_get(PyObject *ob, const char *name, Py_buffer *view,
+		      int maxdim) {
+  if (!PyObject_CheckBuffer(ob)) {
+    PyErr_Format(PyExc_TypeError, "%s must support the buffer protocol, "
+		 "not %.200s", name, Py_TYPE(ob)->tp_name);
+    return 0;
+  }
+  if (PyObject_GetBuffer(ob, view, PyBUF_C_CONTIGUOUS|PyBUF_FORMAT))
+    return 0;
+  if (view->ndim > maxdim || buffer_kind(view)==0) {
+    PyErr_Format(PyExc_TypeError, "%s must be a %s dimensional buffer of "
+		 "numbers, not format '%s'", name, maxdim>1 ? "one or two" :
+		 "one", view->format ? view->format : "B");
+    PyBuffer_Release(view);
+    return 0;
+  }
+  return 1;
+}
+
+int util_buffer_get(PyObject *ob, const char *name, Py_buffer *view) {
+  return buffer_get(ob, name, view, 1);
+}
+
+int util_buffer_get2(PyObject *ob, const char *name, Py_buffer *view) {
+  return buffer_get(ob, name, view, 2);
+}
+
+/* Read item i of the buffer of the given kind as a long long or a
+   double. */
+#define BUFFER_ITEM(view, kind, i, type)				\
+  ((kind)=='f' ? ((view)->itemsize==4 ?					\
+		  (type)((float*)(view)->buf)[i] :			\
+		  (type)((double*)(view)->buf)[i]) :			\
+   (kind)=='i' ? ((view)->itemsize==1 ? (type)((signed char*)(view)->buf)[i] : \
+		  (view)->itemsize==2 ? (type)((short*)(view)->buf)[i] : \
+		  (view)->itemsize==4 ? (type)((int*)(view)->buf)[i] :	\
+		  (type)((long long*)(view)->buf)[i]) :			\
+   ((view)->itemsize==1 ? (type)((unsigned char*)(view)->buf)[i] :	\
+    (view)->itemsize==2 ? (type)((unsigned short*)(view)->buf)[i] :	\
+    (view)->itemsize==4 ? (type)((unsigned int*)(view)->buf)[i] :	\
+    (type)((unsigned long long*)(view)->buf)[i]))
+
+int *util_buffer_ints(Py_buffer *view, const char *name, int offset) {
+  Py_ssize_t i, len = util_buffer_len(view);
+  char kind = buffer_kind(view);
+  int *data;
+  if (kind == 'f') {
+    PyErr_Format(PyExc_TypeError, "%s must hold integers", name);
+    return NULL;
+  }
+  data = (int*)calloc(len ? len : 1, sizeof(int));
+  if (data == NULL) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+  for (i=0; i<len; ++i) {
+    long long v = BUFFER_ITEM(view, kind, i, long long) + offset;
+    if ((kind=='u' && view->itemsize==8 &&
+	 ((unsigned long long*)view->buf)[i] > (unsigned long long)INT_MAX)
+	|| v < INT_MIN || v > INT_MAX) {
+      PyErr_Format(PyExc_OverflowError, "%s entry %zd out of range", name, i);
+      free(data);
+      return NULL;
+    }
+    data[i] = (int)v;
+  }
+  return data;
+}
+
+double *util_buffer_doubles(Py_buffer *view, const char *name,
+			    double **copy) {
+  Py_ssize_t i, len = util_buffer_len(view);
+  char kind = buffer_kind(view);
+  *copy = NULL;
+  if (kind=='f' && view->itemsize==sizeof(double)) return (double*)view->buf;
+  *copy = (double*)calloc(len ? len : 1, sizeof(double));
+  if (*copy == NULL) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+  for (i=0; i<len; ++i) (*copy)[i] = BUFFER_ITEM(view, kind, i, double);
+  return *copy;
+}
+
+#undef BUFFER_ITEM
+
+PyObject *util_new_buffer(const char *format, Py_ssize_t n, void **data) {
+  PyObject *bytes, *view, *cast;
+  Py_ssize_t itemsize;
+  switch (format[0]) {
+  case 'b': case 'B': itemsize = 1; break;
+  case 'i': case 'f': itemsize = 4; break;
+  case 'd': case 'q': itemsize = 8; break;
+  default:
+    PyErr_BadInternalCall();
+    return NULL;
+  }
+  // The bytearray owns the storage; the memoryview reinterprets it.
+  bytes = PyByteArray_FromStringAndSize(NULL, n*itemsize);
+  if (bytes == NULL) return NULL;
+  *data = PyByteArray_AS_STRING(bytes);
+  view = PyMemoryView_FromObject(bytes);
+  Py_DECREF(bytes);
+  if (view == NULL) return NULL;
+  cast = PyObject_CallMethod(view, "cast", "s", format);
+  Py_DECREF(view);
+  return cast;
+}
+
+char *util_temp_path(void) {
+  PyObject *module, *result, *closed;
+  const char *name;
+  char *path = NULL;
+  module = PyImport_ImportModule("tempfile");
+  if (module == NULL) return NULL;
+  result = PyObject_CallMethod(module, "mkstemp", "ss", "", "pyglpk");
+  Py_DECREF(module);
+  if (result == NULL) return NULL;
+  // We only want the name, so close the descriptor mkstemp opened.
+  module = PyImport_ImportModule("os");
+  if (module != NULL) {
+    closed = PyObject_CallMethod(module, "close", "O",
+				 PyTuple_GET_ITEM(result, 0));
+    Py_XDECREF(closed);
+    Py_DECREF(module);
+  }
+  if (!PyErr_Occurred() &&
+      (name = PyString_AsString(PyTuple_GET_ITEM(result, 1))) != NULL) {
+    path = (char*)malloc(strlen(name) + 1);
+    if (path == NULL) PyErr_NoMemory();
+    else strcpy(path, name);
+  }
+  Py_DECREF(result);
+  return path;
+}
+
+int util_memfile_open(util_memfile *f, const void *data, Py_ssize_t len) {
+  FILE *file;
+  int ok;
+  f->fd = -1;
+  f->path = NULL;
+#ifdef UTIL_MEMFD
+  if ((f->fd = memfd_create("pyglpk", MFD_CLOEXEC)) >= 0) {
+    if ((f->path = (char*)malloc(32)) == NULL) {
+      util_memfile_close(f);
+      PyErr_NoMemory();
+      return 0;
+    }
+    sprintf(f->path, "/proc/self/fd/%d", f->fd);
+  }
+#endif
+  // Without memfds, e.g., upon an old kernel, fall back upon a file.
+  if (f->path == NULL && (f->path = util_temp_path()) == NULL) return 0;
+  if (data == NULL) return 1;
+  // Writing through the name works the same for either.
+  file = fopen(f->path, "wb");
+  ok = file != NULL && (Py_ssize_t)fwrite(data, 1, len, file) == len;
+  if (file != NULL && fclose(file) != 0) ok = 0;
+  if (!ok) {
+    PyErr_SetFromErrnoWithFilename(PyExc_IOError, f->path);
+    util_memfile_close(f);
+  }
+  return ok;
+}
+
+PyObject *util_memfile_read(util_memfile *f) {
+  PyObject *bytes = NULL;
+  FILE *file;
+  long size;
+  // GLPK wrote through a descriptor of its own, so open it anew.
+  if ((file = fopen(f->path, "rb")) == NULL)
+    return PyErr_SetFromErrnoWithFilename(PyExc_IOError, f->path);
+  if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 ||
+      fseek(file, 0, SEEK_SET) != 0) {
+    PyErr_SetFromErrnoWithFilename(PyExc_IOError, f->path);
+  } else if ((bytes = PyBytes_FromStringAndSize(NULL, size)) != NULL &&
+	     (long)fread(PyBytes_AS_STRING(bytes), 1, size, file) != size) {
+    Py_CLEAR(bytes);
+    PyErr_SetFromErrnoWithFilename(PyExc_IOError, f->path);
+  }
+  fclose(file);
+  return bytes;
+}
+
+void util_memfile_close(util_memfile *f) {
+  if (f->fd >= 0) close(f->fd);
+  else if (f->path != NULL) remove(f->path);
+  free(f->path);
+  f->fd = -1;
+  f->path = NULL;
+}
+
 int util_add_type(PyObject *module, PyTypeObject *type) {
   if (PyType_Ready(type) < 0) return -1;
   Py_INCREF(type);
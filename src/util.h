@@ -51,6 +51,57 @@ int util_extract_if(PyObject *ob, PyObject *barcol,
 int util_extract_iif(PyObject *ob, PyObject*lp,
 		     int *len, int **ind1, int **ind2, double **val);
 
+/* Acquire a C contiguous, one dimensional view of the numbers held by an
+   object supporting the buffer protocol (e.g., array.array, memoryview, or
+   a NumPy array).  The name is used in error messages.  Returns 0 on
+   failure with an appropriate exception set, 1 on success, in which case
+   the view must later be released with PyBuffer_Release. */
+int util_buffer_get(PyObject *ob, const char *name, Py_buffer *view);
+/* As util_buffer_get, but also accepts a two dimensional buffer, whose
+   rows then lie one after the other in the view. */
+int util_buffer_get2(PyObject *ob, const char *name, Py_buffer *view);
+/* Number of items in a view acquired with util_buffer_get. */
+static inline Py_ssize_t util_buffer_len(Py_buffer *view) {
+  return view->len / view->itemsize; }
+/* Copy the integers in the view into a newly calloc'd array of ints,
+   adding offset to each.  Returns NULL on failure with an exception set,
+   e.g., if the view holds floats or a value does not fit in an int. */
+int *util_buffer_ints(Py_buffer *view, const char *name, int offset);
+/* Return the items of the view as doubles.  If the view already holds
+   native doubles this is the view's own memory and *copy is set to NULL,
+   otherwise the items are converted into a newly calloc'd array which
+   *copy is also set to, and which the caller must free.  Returns NULL on
+   failure with an exception set. */
+double *util_buffer_doubles(Py_buffer *view, const char *name, double **copy);
+/* Create a new writable buffer holding n items of the given struct module
+   format (e.g., "d" or "i"), returned as a memoryview of that format.  A
+   pointer to the uninitialized items is stored in data.  Returns NULL on
+   failure with an exception set. */
+PyObject *util_new_buffer(const char *format, Py_ssize_t n, void **data);
+
+/* Create a new empty temporary file through Python's tempfile module and
+   return its path in a newly malloc'd string, which the caller must free
+   after removing the file.  This backs util_memfile where there is no
+   memfd.  Returns NULL on failure with an exception set. */
+char *util_temp_path(void);
+
+/* A scratch file for GLPK's readers and writers, which only take file
+   names, held in memory where the platform allows: an anonymous memfd on
+   Linux, named by its /proc/self/fd entry, else a temporary file. */
+typedef struct {
+  int fd; // The memfd, or -1 if path is a temporary file.
+  char *path;
+} util_memfile;
+/* Create the file, holding the len bytes of data if it is not NULL.
+   Returns 0 on failure with an exception set, 1 on success, in which case
+   the file must later be closed with util_memfile_close. */
+int util_memfile_open(util_memfile *f, const void *data, Py_ssize_t len);
+/* Return the file's contents as a new bytes object, or NULL on failure
+   with an exception set. */
+PyObject *util_memfile_read(util_memfile *f);
+/* Close and remove the file. */
+void util_memfile_close(util_memfile *f);
+
 /* Generic type addition utility.  Returns 0 if the type was
    successfully added to the module, -1 if not. */
 int util_add_type(PyObject *module, PyTypeObject *type);
@@ -5,6 +5,7 @@
 # GLPK library, and thus have some chance of affecting other tests,
 # and being affected by the workings of other tests.
 
+import copy
 import glpk
 import random
 import gc
@@ -90,6 +91,8 @@ class TerminalTest(unittest.TestCase):
     def tearDown(self):
         # Restore term_on to whatever value it had when we started.
         glpk.env.term_on = self.term_on
+        del glpk.env.term_batch
+        glpk.env.term_interval = 1.0
         del glpk.env.term_hook
 
     def testTerminalRedirect(self):
@@ -180,3 +183,72 @@ class TerminalTest(unittest.TestCase):
             pass
         glpk.env.term_hook = noop_hook
         self.assertEqual(noop_hook, glpk.env.term_hook)
+
+    def testBatchedTermHook(self):
+        """Test passing output to the hook in batches of whole lines."""
+        glpk.env.term_on = True
+        direct, batched = [], []
+
+        def solve(**kwds):
+            self.lp.std_basis()
+            self.lp.simplex(msg_lev=glpk.LPX.MSG_ALL, **kwds)
+        glpk.env.term_hook = direct.append
+        solve()
+        glpk.env.term_batch = 1000
+        glpk.env.term_hook = batched.append
+        solve()
+        # Everything arrives by the time the solver returns.
+        self.assertEqual(''.join(batched), ''.join(direct))
+        self.assertLess(len(batched), len(direct))
+        self.assertTrue(batched[0].endswith('\n'))
+        # A few lines at a time, also without the GIL.
+        for kwds in ({}, {'nogil': True}):
+            del batched[:]
+            glpk.env.term_batch = 1
+            solve(**kwds)
+            self.assertEqual(''.join(batched), ''.join(direct))
+            self.assertGreater(len(batched), 1)
+            for s in batched:
+                self.assertTrue(s.endswith('\n'))
+
+    def testBatchedTermThreads(self):
+        """Test that batched lines from several threads are kept whole."""
+        glpk.env.term_on = True
+        direct, batched = [], []
+        lps = [copy.deepcopy(self.lp) for i in range(8)]
+        glpk.env.term_hook = direct.append
+        self.lp.simplex(msg_lev=glpk.LPX.MSG_ALL)
+        lines = set(''.join(direct).splitlines(True))
+        glpk.env.term_batch = 1
+        glpk.env.term_hook = batched.append
+        glpk.solve_many(lps, threads=4, msg_lev=glpk.LPX.MSG_ALL)
+        for line in ''.join(batched).splitlines(True):
+            self.assertIn(line, lines)
+
+    def testBatchedTermCallbackError(self):
+        """Test that passing on batched output keeps a callback's error."""
+        glpk.env.term_on = True
+        glpk.env.term_batch = 1000
+        glpk.env.term_hook = lambda s: None
+        self.lp.cols[0].kind = int
+
+        class Callback:
+            def default(self, tree):
+                raise ZeroDivisionError()
+        self.assertRaises(ZeroDivisionError, self.lp.integer, presolve=True,
+                          msg_lev=glpk.LPX.MSG_ALL, callback=Callback())
+
+    def testTermBatchType(self):
+        """Test the values term_batch and term_interval accept."""
+        self.assertEqual(glpk.env.term_batch, 0)
+        with self.assertRaises(TypeError):
+            glpk.env.term_batch = 'foo'
+        with self.assertRaises(ValueError):
+            glpk.env.term_batch = -1
+        with self.assertRaises(ValueError):
+            glpk.env.term_interval = -1
+        glpk.env.term_batch = 10
+        self.assertEqual(glpk.env.term_batch, 10)
+        glpk.env.term_batch = None
+        self.assertEqual(glpk.env.term_batch, 0)
+        glpk.env.term_flush()
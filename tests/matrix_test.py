@@ -1,6 +1,7 @@
 """Tests for setting up the LP constraint matrix."""
 
 
+import array
 import glpk
 import random
 import unittest
@@ -315,6 +316,95 @@ class MatrixCoefficientTestCase(unittest.TestCase):
         with self.assertRaises(ValueError):
             self.lp.cols[2].matrix = [(1, 2), (2, 3.1415), (1, 4)]
 
+    def testMatrixCSR(self):
+        """Test exporting the matrix in compressed sparse row form."""
+        self.lp.matrix = self.matrix[::-1]
+        indptr, indices, data = self.lp.matrix_csr()
+        self.assertEqual(list(indptr), [0, 3, 6, 10])
+        self.assertEqual(
+            [(r, indices[k], data[k])
+             for r in range(3) for k in range(indptr[r], indptr[r + 1])],
+            self.matrix)
+        self.assertEqual(array.array('d', data).tolist(),
+                         [v for r, c, v in self.matrix])
+
+    def testMatrixCSC(self):
+        """Test exporting the matrix in compressed sparse column form."""
+        self.lp.matrix = self.matrix
+        indptr, indices, data = self.lp.matrix_csc()
+        self.assertEqual(indptr.format, 'i')
+        self.assertEqual(data.format, 'd')
+        self.assertEqual(list(indptr), [0, 2, 5, 8, 10])
+        self.assertEqual(
+            sorted((indices[k], c, data[k])
+                   for c in range(4) for k in range(indptr[c], indptr[c + 1])),
+            self.matrix)
+        self.assertEqual(list(indices[:5]), [0, 2, 0, 1, 2])
+
+    def testMatrixCompressedEmpty(self):
+        """Test exporting an empty matrix in compressed form."""
+        indptr, indices, data = self.lp.matrix_csr()
+        self.assertEqual(list(indptr), [0, 0, 0, 0])
+        self.assertEqual(len(indices), 0)
+        self.assertEqual(len(data), 0)
+        self.assertEqual(list(self.lp.matrix_csc()[0]), [0, 0, 0, 0, 0])
+
+    def testMatrixCompressedRoundTrip(self):
+        """Test loading the compressed form back with load_matrix."""
+        self.lp.matrix = self.matrix
+        indptr, indices, data = self.lp.matrix_csr()
+        rows = array.array('i', [r for r in range(3)
+                                 for k in range(indptr[r], indptr[r + 1])])
+        self.lp.matrix = None
+        self.lp.load_matrix(rows, indices, data)
+        self.checkMatrix()
+
+    def loadArrays(self, itype='i', vtype='d', mat=None):
+        if mat is None:
+            mat = self.matrix
+        rows, cols, vals = zip(*mat) if mat else ((), (), ())
+        return (array.array(itype, rows), array.array(itype, cols),
+                array.array(vtype, vals))
+
+    def testLoadMatrix(self):
+        """Test loading the matrix from buffers of triplets."""
+        self.lp.load_matrix(*self.loadArrays())
+        self.checkMatrix()
+
+    def testLoadMatrixOtherTypes(self):
+        """Test loading the matrix from buffers of other numeric types."""
+        self.lp.load_matrix(*self.loadArrays('q', 'f'))
+        self.checkMatrix()
+        self.lp.load_matrix(*self.loadArrays('B', 'l'))
+        self.checkMatrix()
+        self.lp.load_matrix(*self.loadArrays('h', 'd', self.matrix[::-1]))
+        self.checkMatrix()
+
+    def testLoadMatrixReplacesAndDropsZeros(self):
+        """Test that loading replaces the matrix and drops zero entries."""
+        self.lp.matrix = self.matrix
+        self.lp.load_matrix(*self.loadArrays(mat=[(1, 1, 0), (2, 3, 4)]))
+        self.checkMatrix([(2, 3, 4)])
+        self.lp.load_matrix(*self.loadArrays(mat=[]))
+        self.checkMatrix([])
+
+    def testLoadMatrixBadArguments(self):
+        """Test loading the matrix with bad buffers."""
+        rows, cols, vals = self.loadArrays()
+        with self.assertRaises(ValueError):
+            self.lp.load_matrix(rows, cols[:-1], vals)
+        with self.assertRaises(TypeError):
+            self.lp.load_matrix(list(rows), cols, vals)
+        with self.assertRaises(TypeError):
+            self.lp.load_matrix(vals, cols, vals)
+        with self.assertRaises(IndexError):
+            self.lp.load_matrix(*self.loadArrays(mat=[(0, 0, 1), (3, 0, 1)]))
+        with self.assertRaises(IndexError):
+            self.lp.load_matrix(*self.loadArrays(mat=[(0, -1, 1)]))
+        with self.assertRaises(ValueError):
+            self.lp.load_matrix(*self.loadArrays(mat=[(0, 1, 2), (0, 1, 3)]))
+        self.checkMatrix([])
+
 
 class MatrixScalingTestCase(unittest.TestCase):
     """Tests the scale and unscale functions."""
@@ -651,3 +651,45 @@ class IntegerControlParametersTestCase(unittest.TestCase):
         for p in (-1, -100, -200, -1000000):
             with self.assertRaises(ValueError):
                 self.lp.integer(out_dly=p)
+
+    def testNodeSelectionTechnique(self):
+        """Test the sel_tech parameter."""
+        legals = LPX.SEL_BT, LPX.SEL_BEP, LPX.SEL_DFP, LPX.SEL_HYB
+        for p in legals:
+            self.lp.integer(sel_tech=p)
+
+    def testNodeSelectionTechniqueValueErrors(self):
+        """Test whether illegal values for sel_tech throw exceptions."""
+        self.runValueErrorTest("sel_tech", [
+            LPX.SEL_BT, LPX.SEL_BEP, LPX.SEL_DFP, LPX.SEL_HYB])
+
+    def testNodeSelectionValueErrors(self):
+        """Test whether illegal values for sel_frq and sel_gap throw
+        exceptions."""
+        for p in (0, -1, -100):
+            with self.assertRaises(ValueError):
+                self.lp.integer(sel_frq=p)
+        for p in (-1e-6, -1, -100):
+            with self.assertRaises(ValueError):
+                self.lp.integer(sel_gap=p)
+
+    def testStrongBranchingTechnique(self):
+        """Test the sb_tech parameter."""
+        for p in LPX.SB_OFF, LPX.SB_FULL, LPX.SB_REL:
+            self.lp.integer(sb_tech=p, sb_cand=1, sb_it_lim=1, sb_rel=0)
+
+    def testStrongBranchingTechniqueValueErrors(self):
+        """Test whether illegal values for sb_tech throw exceptions."""
+        self.runValueErrorTest("sb_tech", [
+            LPX.SB_OFF, LPX.SB_FULL, LPX.SB_REL])
+
+    def testStrongBranchingValueErrors(self):
+        """Test whether illegal values for sb_cand, sb_it_lim and sb_rel
+        throw exceptions."""
+        for name in 'sb_cand', 'sb_it_lim':
+            for p in (0, -1, -100):
+                with self.assertRaises(ValueError):
+                    self.lp.integer(**{name: p})
+        for p in (-1, -100):
+            with self.assertRaises(ValueError):
+                self.lp.integer(sb_rel=p)
@@ -1,11 +1,22 @@
 """Tests for reading and writing problems and solutions."""
 
+import concurrent.futures
+import copy
+import pickle
+import struct
 import tempfile
 import unittest
 
 from glpk import LPX
 
 
+def solve_shared(name):
+    """Solve the problem in shared memory, returning its solution there."""
+    lp = LPX.from_shared_memory(name)
+    lp.simplex()
+    return lp.solution_to_shared_memory()
+
+
 class WriteTests(unittest.TestCase):
     """A simple suite of tests for this problem.
 
@@ -195,6 +206,29 @@ class WriteTests(unittest.TestCase):
             str(cm.exception)
         )
 
+    def testBasis(self):
+        """Test writing and reading back a basis."""
+        self.lp.simplex()
+        row_stat, col_stat = self.lp.get_basis()
+        self.lp.write_basis(self.f.name)
+        self.lp.std_basis()
+        self.assertIsNone(self.lp.read_basis(self.f.name, warm_up=True))
+        self.assertEqual(list(self.lp.get_basis()[0]), list(row_stat))
+        self.assertEqual(list(self.lp.get_basis()[1]), list(col_stat))
+        self.assertAlmostEqual(self.lp.cols['y'].primal, 0.5)
+
+        # the basis must match the problem dimensions
+        self.lp.cols.add(1)
+        with self.assertRaises(ValueError):
+            self.lp.read_basis(self.f.name)
+
+        # other files are not bases
+        self.lp.write(glp=self.f.name)
+        with self.assertRaises(ValueError):
+            self.lp.read_basis(self.f.name)
+        with self.assertRaises(IOError):
+            self.lp.write_basis('not/a/real/file')
+
     def testWriteMip(self):
         """Test writing MIP solution."""
         self.lp.simplex()
@@ -208,3 +242,269 @@ class WriteTests(unittest.TestCase):
             "writer for 'mip' failed to write to 'not/a/real/file'",
             str(cm.exception)
         )
+
+    def testBytes(self):
+        """Test reading/writing problems in memory."""
+        for format in 'mps', 'freemps', 'cpxlp', 'glp':
+            data = self.lp.to_bytes(format)
+            self.assertIsInstance(data, bytes)
+            lp = LPX.from_bytes(data, format=format)
+            self.assertEqual(len(lp.rows), 1)
+            self.assertEqual(len(lp.cols), 2)
+            self.assertEqual(lp.cols[0].name, 'x')
+            self.assertEqual(lp.cols[1].name, 'y')
+            lp.simplex()
+            self.assertAlmostEqual(lp.obj.value, 1.5)
+
+        # the same as writing to a file
+        self.lp.write(glp=self.f.name)
+        with open(self.f.name, 'rb') as f:
+            self.assertEqual(self.lp.to_bytes(format='glp'), f.read())
+
+        # any bytes-like object serves
+        data = self.lp.to_bytes()
+        for ob in bytearray(data), memoryview(data):
+            self.assertEqual(len(LPX.from_bytes(ob).cols), 2)
+
+        with self.assertRaises(ValueError):
+            self.lp.to_bytes('lp')
+        with self.assertRaises(ValueError):
+            LPX.from_bytes(data, 'lp')
+        with self.assertRaises(TypeError):
+            LPX.from_bytes('not bytes')
+        with self.assertRaises(RuntimeError) as cm:
+            LPX.from_bytes(b'not a problem', format='glp')
+        self.assertIn('GLPK LP/MIP reader failed', str(cm.exception))
+
+    def testSnapshot(self):
+        """Test saving and loading binary snapshots."""
+        self.lp.name = 'snap'
+        self.lp.rows[0].name = 'c'
+        self.lp.cols[1].kind = int
+        self.lp.simplex()
+        self.lp.save_snapshot(self.f.name)
+        lp = LPX.load_snapshot(self.f.name)
+        self.assertEqual(lp.name, 'snap')
+        self.assertEqual(lp.rows[0].name, 'c')
+        self.assertEqual([c.name for c in lp.cols], ['x', 'y'])
+        self.assertEqual([c.bounds for c in lp.cols], [(0, 1), (0, 1)])
+        self.assertEqual(lp.rows[0].bounds, (None, 1))
+        self.assertEqual(lp.rows[0].matrix, [(0, 0.5), (1, 1.0)])
+        self.assertEqual(lp.obj[:], [1, 1])
+        self.assertTrue(lp.obj.maximize)
+        self.assertEqual([c.kind for c in lp.cols],
+                         [c.kind for c in self.lp.cols])
+        # the solution comes along, without solving again
+        self.assertEqual(lp.status, 'opt')
+        self.assertAlmostEqual(lp.obj.value, 1.5)
+        self.assertAlmostEqual(lp.cols[0].primal, 1.0)
+        self.assertAlmostEqual(lp.cols[1].primal, 0.5)
+        self.assertEqual([c.status for c in lp.cols],
+                         [c.status for c in self.lp.cols])
+
+        # the MIP solution of the last solver
+        self.lp.integer()
+        self.lp.save_snapshot(self.f.name)
+        lp = LPX.load_snapshot(self.f.name)
+        self.assertEqual(lp.status, 'opt')
+        self.assertAlmostEqual(lp.obj.value, 1.0)
+        self.assertAlmostEqual(lp.cols[1].primal, self.lp.cols[1].primal)
+
+        # leaving optional sections out
+        self.lp.save_snapshot(self.f.name, names=False, solution=False)
+        lp = LPX.load_snapshot(self.f.name)
+        self.assertEqual(lp.cols[0].name, None)
+        self.assertEqual(len(lp.cols), 2)
+        lp.simplex()
+        self.assertAlmostEqual(lp.obj.value, 1.5)
+
+        # an empty problem
+        LPX().save_snapshot(self.f.name)
+        lp = LPX.load_snapshot(self.f.name)
+        self.assertEqual((len(lp.rows), len(lp.cols)), (0, 0))
+
+        # a row with a repeated column, which GLPK would abort upon
+        self.lp.save_snapshot(self.f.name, names=False, basis=False,
+                              solution=False)
+        with open(self.f.name, 'rb') as f:
+            data = f.read()
+        ind = struct.pack('=3i', 0, 1, 2)  # the column indices, 1-based
+        at = data.index(ind, 56)
+        with open(self.f.name, 'wb') as f:
+            f.write(data[:at] + struct.pack('=3i', 0, 1, 1) +
+                    data[at + len(ind):])
+        with self.assertRaises(ValueError) as cm:
+            LPX.load_snapshot(self.f.name)
+        self.assertIn('duplicate', str(cm.exception))
+
+        # files that are not snapshots, or are cut short
+        self.lp.save_snapshot(self.f.name)
+        with open(self.f.name, 'rb') as f:
+            data = f.read()
+        for bad in b'', b'GLPKSNAP', data[:len(data) // 2]:
+            with open(self.f.name, 'wb') as f:
+                f.write(bad)
+            with self.assertRaises(ValueError):
+                LPX.load_snapshot(self.f.name)
+        self.lp.write(mps=self.f.name)
+        with self.assertRaises(ValueError):
+            LPX.load_snapshot(self.f.name)
+        with self.assertRaises(IOError):
+            LPX.load_snapshot('not a real file')
+        with self.assertRaises(IOError):
+            self.lp.save_snapshot('not/a/real/file')
+
+    def testPickle(self):
+        """Test pickling problems, with their solutions."""
+        self.lp.name = 'pickled'
+        self.lp.simplex()
+        for protocol in range(pickle.HIGHEST_PROTOCOL + 1):
+            lp = pickle.loads(pickle.dumps(self.lp, protocol))
+            self.assertIsInstance(lp, LPX)
+            self.assertEqual(lp.name, 'pickled')
+            self.assertEqual([c.name for c in lp.cols], ['x', 'y'])
+            self.assertEqual(lp.rows[0].matrix, [(0, 0.5), (1, 1.0)])
+            self.assertEqual(lp.status, 'opt')
+            self.assertAlmostEqual(lp.obj.value, 1.5)
+            self.assertAlmostEqual(lp.cols[1].primal, 0.5)
+
+        # copies are independent
+        lp = copy.deepcopy(self.lp)
+        lp.cols.add(1)
+        self.assertEqual(len(self.lp.cols), 2)
+
+        if pickle.HIGHEST_PROTOCOL >= 5:
+            # the snapshot goes out-of-band
+            buffers = []
+            data = pickle.dumps(self.lp, 5, buffer_callback=buffers.append)
+            self.assertEqual(len(buffers), 1)
+            self.assertLess(len(data), 100)
+            lp = pickle.loads(data, buffers=buffers)
+            self.assertAlmostEqual(lp.obj.value, 1.5)
+
+        # the state only loads into an empty problem
+        with self.assertRaises(RuntimeError):
+            self.lp.__setstate__(self.lp.__reduce__()[2])
+        with self.assertRaises(ValueError):
+            LPX().__setstate__(b'not a snapshot')
+
+    def testSnapshotExact(self):
+        """Test that snapshots keep solutions bit for bit."""
+        self.lp.rows[0].bounds = None, 1 / 3.0
+        for solve in (self.lp.simplex, self.lp.interior):
+            solve()
+            self.lp.save_snapshot(self.f.name)
+            for lp in (pickle.loads(pickle.dumps(self.lp)),
+                       LPX.load_snapshot(self.f.name)):
+                self.assertEqual(lp.obj.value, self.lp.obj.value)
+                self.assertEqual([c.primal for c in lp.cols],
+                                 [c.primal for c in self.lp.cols])
+                self.assertEqual(lp.rows[0].dual, self.lp.rows[0].dual)
+
+    def testSharedMemory(self):
+        """Test exchanging problems and solutions in shared memory."""
+        shm = self.lp.to_shared_memory()
+        try:
+            for handle in shm, shm.name:
+                lp = LPX.from_shared_memory(handle)
+                self.assertEqual([c.name for c in lp.cols], ['x', 'y'])
+                self.assertEqual(lp.rows[0].matrix, [(0, 0.5), (1, 1.0)])
+                lp.simplex()
+                self.assertAlmostEqual(lp.obj.value, 1.5)
+
+            # the solution comes back without the problem
+            sol = lp.solution_to_shared_memory()
+            try:
+                self.lp.solution_from_shared_memory(sol.name)
+                self.assertEqual(self.lp.status, 'opt')
+                self.assertAlmostEqual(self.lp.obj.value, 1.5)
+                self.assertAlmostEqual(self.lp.cols['y'].primal, 0.5)
+                # the values are those of the worker's solve, bit for bit
+                self.assertEqual([c.primal for c in self.lp.cols],
+                                 [c.primal for c in lp.cols])
+                self.assertEqual(self.lp.rows[0].dual, lp.rows[0].dual)
+                lp.cols.add(1)
+                with self.assertRaises(ValueError):
+                    lp.solution_from_shared_memory(sol)
+            finally:
+                sol.close()
+                sol.unlink()
+
+            with self.assertRaises(ValueError):
+                self.lp.solution_from_shared_memory(shm)
+        finally:
+            shm.close()
+            shm.unlink()
+        with self.assertRaises(RuntimeError):
+            LPX().solution_to_shared_memory()
+
+    def testSharedMemoryPool(self):
+        """Test solving a problem in shared memory in worker processes."""
+        shm = self.lp.to_shared_memory()
+        try:
+            with concurrent.futures.ProcessPoolExecutor(2) as pool:
+                sols = list(pool.map(solve_shared, [shm.name] * 2))
+            for sol in sols:
+                lp = LPX.from_shared_memory(shm)
+                lp.solution_from_shared_memory(sol)
+                self.assertAlmostEqual(lp.obj.value, 1.5)
+                sol.close()
+                sol.unlink()
+        finally:
+            shm.close()
+            shm.unlink()
+
+    def testSolution(self):
+        """Test writing solutions and reading them back."""
+        self.lp.simplex()
+        self.lp.write_solution(self.f.name)
+        lp = LPX.from_bytes(self.lp.to_bytes())
+        self.assertIsNone(lp.read_solution(self.f.name))
+        self.assertEqual(lp.status, 'opt')
+        self.assertAlmostEqual(lp.obj.value, 1.5)
+        self.assertAlmostEqual(lp.cols[1].primal, 0.5)
+        self.assertAlmostEqual(lp.rows[0].dual, self.lp.rows[0].dual)
+        self.assertEqual([c.status for c in lp.cols],
+                         [c.status for c in self.lp.cols])
+
+        # each kind of solution, in memory
+        self.lp.interior()
+        self.lp.cols[1].kind = int
+        self.lp.integer()
+        for kind, value in ('simplex', 1.5), ('interior', 1.5), \
+                ('integer', 1.0):
+            data = self.lp.solution_to_bytes(kind)
+            self.assertIsInstance(data, bytes)
+            lp.solution_from_bytes(data, kind=kind)
+            self.assertAlmostEqual(lp.obj.value, value, 5)
+        # by default that of the last solver
+        self.assertEqual(self.lp.solution_to_bytes(),
+                         self.lp.solution_to_bytes('integer'))
+        data = self.lp.solution_to_bytes('simplex')
+        lp.solution_from_bytes(bytearray(data))
+        self.assertAlmostEqual(lp.obj.value, 1.5)
+
+        with self.assertRaises(ValueError):
+            self.lp.solution_to_bytes('exact')
+        with self.assertRaises(ValueError):
+            lp.read_solution(self.f.name, kind='basic')
+        with self.assertRaises(RuntimeError):
+            LPX().solution_to_bytes()
+        with self.assertRaises(RuntimeError):
+            LPX().write_solution(self.f.name)
+
+        # the solution must be of a problem of the same dimensions
+        lp.cols.add(1)
+        with self.assertRaises(RuntimeError):
+            lp.read_solution(self.f.name)
+        with self.assertRaises(RuntimeError):
+            lp.solution_from_bytes(b'not a solution')
+        with self.assertRaises(RuntimeError) as cm:
+            lp.read_solution('not a real file')
+        self.assertIn("reader for 'simplex' failed", str(cm.exception))
+        with self.assertRaises(RuntimeError) as cm:
+            self.lp.write_solution('not/a/real/file')
+        self.assertIn(
+            "writer for 'integer' failed to write to 'not/a/real/file'",
+            str(cm.exception)
+        )
@@ -1,9 +1,13 @@
 """Tests for the solver itself."""
 
-from glpk import env, LPX
+from glpk import env, LPX, solve_many, CancelToken
 import sys
 import unittest
 from itertools import cycle
+from array import array
+import threading
+import asyncio
+import ctypes
 
 
 class SimpleSolverTest(unittest.TestCase):
@@ -47,6 +51,93 @@ class SimpleSolverTest(unittest.TestCase):
         self.assertAlmostEqual(self.lp.cols['x'].value, 1.0)
         self.assertAlmostEqual(self.lp.cols['y'].value, 0.5)
 
+    def testSolveConcurrent(self):
+        """Tests racing LP methods on the simple problem."""
+        retval, winner = self.lp.solve_concurrent()
+        self.assertIsNone(retval)
+        self.assertIn(winner, ('primal', 'dual'))
+        self.assertAlmostEqual(self.lp.cols['x'].value, 1.0)
+        self.assertAlmostEqual(self.lp.cols['y'].value, 0.5)
+        for method in ('primal', 'dual', 'dualp'):
+            self.assertEqual(self.lp.solve_concurrent([method]),
+                             (None, method))
+            self.assertEqual(self.lp.status, 'opt')
+            self.assertEqual(list(self.lp.get_basis()[1]), [LPX.NU, LPX.BS])
+        self.assertEqual(self.lp.solve_concurrent(methods=['interior']),
+                         (None, 'interior'))
+        self.assertAlmostEqual(self.lp.cols['y'].value, 0.5)
+        # an interior loser is waited for, so the problem may then change
+        retval, winner = self.lp.solve_concurrent(['interior', 'primal'])
+        self.assertIsNone(retval)
+        self.lp.rows.add(1)
+        del self.lp.rows[1]
+        self.assertEqual(self.lp.solve_concurrent(['primal'], it_lim=0),
+                         ('itlim', 'primal'))
+        self.assertRaises(ValueError, self.lp.solve_concurrent, ['foo'])
+        self.assertRaises(ValueError, self.lp.solve_concurrent, [])
+        self.assertRaises(ValueError, self.lp.solve_concurrent, tol_bnd=2)
+
+    def testSolveNoGil(self):
+        """Tests solving the simple problem without holding the GIL."""
+        for solve in (self.lp.simplex, self.lp.exact, self.lp.interior):
+            self.assertIsNone(solve(nogil=True))
+            self.assertAlmostEqual(self.lp.cols['x'].value, 1.0)
+            self.assertAlmostEqual(self.lp.cols['y'].value, 0.5)
+
+    def testPrimalDualArrays(self):
+        """Tests reading all primal and dual values at once."""
+        self.lp.simplex()
+        primal = self.lp.cols.primal_array()
+        self.assertEqual(primal.format, 'd')
+        self.assertEqual(len(primal), 2)
+        self.assertAlmostEqual(primal[0], 1.0)
+        self.assertAlmostEqual(primal[1], 0.5)
+        for bc in (self.lp.rows, self.lp.cols):
+            self.assertEqual(list(bc.primal_array()),
+                             [b.primal for b in bc])
+            self.assertEqual(list(bc.dual_array()), [b.dual for b in bc])
+            self.assertEqual(list(bc.dual_array('simplex')),
+                             [b.dual_s for b in bc])
+        self.lp.interior()
+        for bc in (self.lp.rows, self.lp.cols):
+            self.assertEqual(list(bc.primal_array()),
+                             [b.primal_i for b in bc])
+            self.assertEqual(list(bc.dual_array(solver='interior')),
+                             [b.dual_i for b in bc])
+            self.assertEqual(list(bc.primal_array('simplex')),
+                             [b.primal_s for b in bc])
+        self.assertRaises(ValueError, self.lp.cols.primal_array, 'foo')
+        self.assertRaises(TypeError, self.lp.cols.primal_array, 'integer')
+
+    def testGetSetBasis(self):
+        """Tests exporting an optimal basis and warm-starting from it."""
+        self.lp.simplex()
+        row_stat, col_stat = self.lp.get_basis()
+        self.assertEqual(row_stat.format, 'b')
+        self.assertEqual(list(row_stat), [LPX.NU])
+        self.assertEqual(list(col_stat), [LPX.NU, LPX.BS])
+        self.assertEqual([b.status for b in self.lp.cols], ['nu', 'bs'])
+        self.lp.std_basis()
+        self.assertNotEqual(list(self.lp.get_basis()[1]), list(col_stat))
+        self.assertIsNone(self.lp.set_basis(row_stat, col_stat,
+                                            warm_up=True))
+        self.assertAlmostEqual(self.lp.cols['x'].primal, 1.0)
+        self.assertAlmostEqual(self.lp.cols['y'].primal, 0.5)
+        self.lp.simplex()
+        self.assertEqual(self.lp.status, 'opt')
+
+    def testSetBadBasis(self):
+        """Tests that bad bases are rejected without changing anything."""
+        self.lp.simplex()
+        row_stat, col_stat = self.lp.get_basis()
+        with self.assertRaises(ValueError):
+            self.lp.set_basis(row_stat, col_stat[:1])
+        with self.assertRaises(ValueError):
+            self.lp.set_basis(row_stat, bytearray([LPX.NL, 9]))
+        with self.assertRaises(TypeError):
+            self.lp.set_basis(row_stat, [LPX.NL, LPX.BS])
+        self.assertEqual(list(self.lp.get_basis()[1]), list(col_stat))
+
     def testSimplexKKT(self):
         """Tests the KKT check with solution from simplex solver."""
         # Solve test LP using the simplex method,
@@ -194,6 +285,13 @@ class SimpleIntegerSolverTest(unittest.TestCase):
         self.assertAlmostEqual(self.lp.cols['y'].value, 0.0)
         self.assertAlmostEqual(self.lp.obj.value, 2.0)
 
+    def testIntegerArrays(self):
+        """Tests reading all MIP values at once."""
+        self.lp.integer(presolve=True)
+        self.assertEqual(list(self.lp.cols.primal_array()), [1.0, 0.0])
+        self.assertEqual(list(self.lp.rows.primal_array('integer')), [0.5])
+        self.assertRaises(RuntimeError, self.lp.cols.dual_array)
+
     def testIntegerKKT(self):
         """Tests the KKT check with solution from integer solver."""
         # Solve test LP using the simplex method,
@@ -229,6 +327,29 @@ class SimpleIntegerSolverTest(unittest.TestCase):
         self.assertTrue(kkt.pe_quality in ['H', 'M', 'L', '?'])
         self.assertTrue(kkt.pb_quality in ['H', 'M', 'L', '?'])
 
+    def testIntegerRace(self):
+        """Tests racing configurations of the integer solver."""
+        configs = [{'br_tech': LPX.BR_FFV}, {'br_tech': LPX.BR_MFV},
+                   {'bt_tech': LPX.BT_BPH, 'gmi_cuts': True},
+                   {'pp_tech': LPX.PP_ALL, 'mir_cuts': True}]
+        retval, winner = self.lp.integer_race(configs, presolve=True)
+        self.assertIsNone(retval)
+        self.assertIn(winner, range(len(configs)))
+        self.assertEqual(self.lp.status, 'opt')
+        self.assertAlmostEqual(self.lp.cols['x'].value, 1.0)
+        self.assertAlmostEqual(self.lp.cols['y'].value, 0.0)
+        self.assertAlmostEqual(self.lp.obj.value, 2.0)
+        # Configurations are checked like the arguments of integer().
+        self.assertRaises(ValueError, self.lp.integer_race, [])
+        self.assertRaises(TypeError, self.lp.integer_race, [None])
+        self.assertRaises(TypeError, self.lp.integer_race, [{'bogus': 1}])
+        self.assertRaises(ValueError, self.lp.integer_race,
+                          [{'callback': object()}], presolve=True)
+        lp = LPX()
+        lp.cols.add(1)
+        self.assertRaises(RuntimeError, lp.integer_race, [{}])
+        self.assertEqual(self.lp.integer_race([{}], presolve=True), (None, 0))
+
     def testIntOpt(self):
         """Test solving a simple integer program w/ intopt."""
         # FIXME: documentation claims that this method does not require an
@@ -644,6 +765,46 @@ class MIPCallbackTest(unittest.TestCase):
         assign = self.solve_sat(callback=Callback())
         self.assertTrue(self.verify(self.expression, assign))
 
+    def testCallbackResolvedOnce(self):
+        """Tests that callback methods are looked up once per solve."""
+        lookups = []
+        calls = []
+
+        class Callback:
+            def __getattribute__(self, name):
+                lookups.append(name)
+                return object.__getattribute__(self, name)
+
+            def default(self, tree):
+                calls.append(tree.reason)
+
+        assign = self.solve_sat(callback=Callback())
+        self.assertTrue(self.verify(self.expression, assign))
+        self.assertTrue(calls)
+        # Those of default and the seven reasons' methods.
+        self.assertLessEqual(len(lookups), 8)
+
+    def testCallbackTreeReused(self):
+        """Tests that one Tree object is valid in each call, and only then."""
+        trees = []
+
+        class Callback:
+            def bingo(self, tree):
+                self.check(tree)
+
+            def select(self, tree):
+                self.check(tree)
+
+            def check(self, tree):
+                tree.num_active
+                trees.append(tree)
+
+        assign = self.solve_sat(callback=Callback())
+        self.assertTrue(self.verify(self.expression, assign))
+        self.assertTrue(trees)
+        self.assertTrue(all(tree is trees[0] for tree in trees))
+        self.assertRaises(RuntimeError, trees[0].terminate)
+
     def testCallbackTerminate(self):
         """Tests that termination actually stops the solver."""
         testobj = self
@@ -735,6 +896,37 @@ class MIPCallbackTest(unittest.TestCase):
         assign = self.solve_sat(callback=Callback())
         self.assertTrue(self.verify(self.expression, assign))
 
+    def testActiveNodes(self):
+        """Test reading the active list as arrays, and selecting by number."""
+        testobj = self
+
+        class Callback:
+            def __init__(self):
+                self.selects = 0
+
+            def select(self, tree):
+                ids, levels, bounds, parents = tree.active_nodes()
+                nodes = list(tree)
+                testobj.assertEqual(list(ids), [n.subproblem for n in nodes])
+                testobj.assertEqual(list(levels), [n.level for n in nodes])
+                testobj.assertEqual(list(bounds), [n.bound for n in nodes])
+                testobj.assertEqual(list(parents), [
+                    n.up.subproblem if n.up else 0 for n in nodes])
+                testobj.assertEqual(len(ids), tree.num_active)
+                testobj.assertRaises(ValueError, tree.select, 0)
+                testobj.assertRaises(TypeError, tree.select, 'x')
+                tree.select(ids[-1])
+                self.selects += 1
+
+            def default(self, tree):
+                testobj.assertEqual(len(tree.active_nodes()[0]),
+                                    tree.num_active)
+
+        callback = Callback()
+        assign = self.solve_sat(callback=callback)
+        self.assertTrue(self.verify(self.expression, assign))
+        self.assertTrue(callback.selects)
+
     def testTreeNodeRichCompare(self):
         testobj = self
 
@@ -942,6 +1134,27 @@ class MIPCallbackTest(unittest.TestCase):
         assign = self.solve_sat(callback=Callback())
         self.assertTrue(self.verify(self.expression, assign))
 
+    def testCallbackNoGil(self):
+        """Tests that callbacks still run when the GIL is released."""
+        reasons = set()
+
+        class Callback:
+            def default(self, tree):
+                reasons.add(tree.reason)
+
+        assign = self.solve_sat(callback=Callback(), nogil=True)
+        self.assertTrue(self.verify(self.expression, assign))
+        self.assertNotEqual(len(reasons), 0)
+
+    def testBadCallbackNoGil(self):
+        """Tests that callback errors propagate when the GIL is released."""
+        class Callback:
+            def default(self, tree):
+                1 / 0
+
+        with self.assertRaises(ZeroDivisionError):
+            self.solve_sat(callback=Callback(), nogil=True)
+
     def testTreeGap(self):
         testobj = self
         self.old_gap = float('inf')
@@ -956,3 +1169,593 @@ class MIPCallbackTest(unittest.TestCase):
 
         assign = self.solve_sat(callback=Callback())
         self.assertTrue(self.verify(self.expression, assign))
+
+
+def build_lp(k=1, kind=float, names=False, obj=(1, 1)):
+    """Builds the problem of maximizing obj over x and y in [0, k] with
+    0.5x + y <= k, of the given column kind."""
+    lp = LPX()
+    lp.rows.add(1)
+    lp.cols.add(2)
+    if names:
+        lp.cols[0].name, lp.cols[1].name = 'x', 'y'
+    for c in lp.cols:
+        c.bounds = 0, k
+        c.kind = kind
+    lp.obj[:] = list(obj)
+    lp.obj.maximize = True
+    lp.rows[0].matrix = [0.5, 1.0]
+    lp.rows[0].bounds = None, k
+    return lp
+
+
+class ThreadedSolveTest(unittest.TestCase):
+    """Solve independent problems from several threads at once."""
+    def testThreads(self):
+        results = {}
+
+        def solve(k):
+            lp = build_lp(k)
+            for i in range(50):
+                lp.std_basis()
+                lp.simplex(nogil=True)
+            results[k] = lp.obj.value
+
+        threads = [threading.Thread(target=solve, args=(k,))
+                   for k in range(1, 5)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual(sorted(results), [1, 2, 3, 4])
+        for k, value in results.items():
+            self.assertAlmostEqual(value, 1.5 * k)
+
+
+class SolveManyTest(unittest.TestCase):
+    """Solve batches of independent problems on native worker threads."""
+    def testSimplex(self):
+        """Tests a batch of simplex solves."""
+        lps = [build_lp(k) for k in range(1, 21)]
+        self.assertEqual(solve_many(lps, threads=4), [None] * 20)
+        for k, lp in enumerate(lps, 1):
+            self.assertEqual(lp.status, 'opt')
+            self.assertAlmostEqual(lp.obj.value, 1.5 * k)
+            self.assertAlmostEqual(lp.cols[0].primal, k)
+            self.assertAlmostEqual(lp.cols[1].primal, 0.5 * k)
+            self.assertAlmostEqual(lp.rows[0].dual, 1.0)
+            self.assertEqual(list(lp.get_basis()[1]), [LPX.NU, LPX.BS])
+
+    def testMethods(self):
+        """Tests a batch with each solver method."""
+        lps = [build_lp(k) for k in range(1, 5)]
+        for method in ('exact', 'interior'):
+            self.assertEqual(solve_many(lps, method), [None] * 4)
+            for k, lp in enumerate(lps, 1):
+                self.assertEqual(lp.status, 'opt')
+                self.assertAlmostEqual(lp.obj.value, 1.5 * k)
+        lps = [build_lp(k, int) for k in range(1, 5)]
+        self.assertEqual(solve_many(lps, method='integer', presolve=True),
+                         [None] * 4)
+        for k, lp in enumerate(lps, 1):
+            self.assertEqual(lp.status, 'opt')
+            self.assertAlmostEqual(lp.obj.value, k + k // 2)
+            self.assertAlmostEqual(lp.obj.value_m, k + k // 2)
+
+    def testExact(self):
+        """Tests that handed back solutions equal those of direct solves."""
+        for method in ('simplex', 'interior'):
+            lp, direct = build_lp(1 / 3.0), build_lp(1 / 3.0)
+            lp.name, lp.cols[0].name = 'p', 'x'
+            self.assertEqual(solve_many([lp], method), [None])
+            getattr(direct, method)()
+            self.assertEqual(lp.obj.value, direct.obj.value)
+            self.assertEqual([c.primal for c in lp.cols],
+                             [c.primal for c in direct.cols])
+            self.assertEqual(lp.rows[0].dual, direct.rows[0].dual)
+            self.assertEqual((lp.name, lp.cols['x'].index), ('p', 0))
+
+    def testParams(self):
+        """Tests that parameters are checked like the solver methods."""
+        lps = [build_lp(1)]
+        self.assertEqual(solve_many(lps, it_lim=0), ['itlim'])
+        self.assertRaises(ValueError, solve_many, lps, tol_bnd=2)
+        self.assertRaises(TypeError, solve_many, lps, bogus=1)
+        self.assertRaises(TypeError, solve_many, lps, 'interior', msg_lev=1)
+        self.assertRaises(ValueError, solve_many, lps, 'foo')
+        self.assertRaises(ValueError, solve_many, lps, threads=0)
+        self.assertRaises(TypeError, solve_many, [lps[0], 'x'])
+        self.assertRaises(ValueError, solve_many, lps, 'integer',
+                          presolve=True, callback=object())
+        self.assertRaises(RuntimeError, solve_many, lps, 'integer')
+        self.assertEqual(solve_many([]), [])
+
+    def testDuplicateProblem(self):
+        """Tests that one problem cannot be solved twice at once."""
+        lp = build_lp(1)
+        self.assertRaises(RuntimeError, solve_many, [lp, lp])
+        # The failed attempt must leave the problem usable.
+        self.assertIsNone(lp.simplex())
+        self.assertEqual(solve_many([lp]), [None])
+
+
+class AsyncSolveTest(unittest.TestCase):
+    """Await solves running on native threads from an asyncio loop."""
+    def testSimplex(self):
+        """Tests awaiting a simplex solve."""
+        lp = build_lp(3, names=True)
+        async def solve():
+            future = lp.simplex_async()
+            # A second solve cannot start until the first is done.
+            self.assertRaises(RuntimeError, lp.simplex)
+            return await future
+        self.assertIsNone(asyncio.run(solve()))
+        self.assertEqual(lp.status, 'opt')
+        self.assertAlmostEqual(lp.obj.value, 4.5)
+        self.assertAlmostEqual(lp.cols[1].primal, 1.5)
+        self.assertIsNone(lp.simplex())
+
+    def testConcurrent(self):
+        """Tests several solves awaited together."""
+        lps = [build_lp(3, names=True) for i in range(8)]
+        async def solve():
+            return await asyncio.gather(*[lp.simplex_async() for lp in lps])
+        self.assertEqual(asyncio.run(solve()), [None] * 8)
+        for lp in lps:
+            self.assertAlmostEqual(lp.obj.value, 4.5)
+
+    def testParams(self):
+        """Tests that parameters are checked like the solver methods."""
+        lp = build_lp(3, names=True)
+        async def solve():
+            self.assertRaises(ValueError, lp.simplex_async, tol_bnd=2)
+            self.assertRaises(TypeError, lp.integer_async, bogus=1)
+            self.assertRaises(RuntimeError, lp.integer_async)
+            return await lp.simplex_async(it_lim=0)
+        self.assertEqual(asyncio.run(solve()), 'itlim')
+        # There must be a running event loop.
+        self.assertRaises(RuntimeError, lp.simplex_async)
+
+    def testInteger(self):
+        """Tests awaiting an integer solve with a callback on the loop."""
+        lp = build_lp(3, int, names=True)
+        testobj = self
+        class Callback:
+            def __init__(self):
+                self.reasons = set()
+            def default(self, tree):
+                testobj.assertIs(threading.current_thread(), main)
+                testobj.assertEqual(len(tree.lp.cols), 2)
+                testobj.assertEqual(tree.lp.cols['y'].index, 1)
+                self.reasons.add(tree.reason)
+        main = threading.current_thread()
+        callback = Callback()
+        lp.simplex()
+        async def solve():
+            return await lp.integer_async(callback=callback)
+        self.assertIsNone(asyncio.run(solve()))
+        self.assertEqual(lp.status, 'opt')
+        self.assertAlmostEqual(lp.obj.value, 4)
+        self.assertTrue(callback.reasons)
+
+    def testIntegerCallbackError(self):
+        """Tests that an error in a callback is set upon the future."""
+        lp = build_lp(3, int, names=True)
+        class Callback:
+            def default(self, tree):
+                raise ZeroDivisionError()
+        lp.simplex()
+        async def solve():
+            return await lp.integer_async(callback=Callback())
+        self.assertRaises(ZeroDivisionError, asyncio.run, solve())
+        self.assertIsNone(lp.integer())
+
+    def testIntegerCallbackCuts(self):
+        """Tests that cuts cannot be added from another thread."""
+        lp = build_lp(3, int, names=True)
+        class Callback:
+            def rowgen(self, tree):
+                tree.add_cuts(array('i', [0, 1]),
+                              array('i', [0]),
+                              array('d', [1.0]),
+                              array('d', [10.0]))
+        lp.simplex()
+        async def solve():
+            return await lp.integer_async(callback=Callback())
+        with self.assertRaises(RuntimeError) as cm:
+            asyncio.run(solve())
+        self.assertIn('asynchronous', str(cm.exception))
+        self.assertIsNone(lp.integer())
+
+    def testIntegerCallbackReadOnly(self):
+        """Tests that the solver's problem cannot be changed from another
+        thread, but can be read."""
+        lp = build_lp(3, int, names=True)
+        changes = [lambda lp: lp.rows.add(1),
+                   lambda lp: lp.erase(),
+                   lambda lp: setattr(lp, 'name', 'x'),
+                   lambda lp: setattr(lp.cols[0], 'bounds', (0, 2)),
+                   lambda lp: lp.obj.__setitem__(0, 3.0),
+                   lambda lp: lp.simplex()]
+        for change in changes:
+            class Callback:
+                def default(self, tree):
+                    self.numcols = len(tree.lp.cols)
+                    change(tree.lp)
+            callback = Callback()
+            lp.simplex()
+            async def solve():
+                return await lp.integer_async(callback=callback)
+            with self.assertRaises(RuntimeError) as cm:
+                asyncio.run(solve())
+            self.assertIn('asynchronous', str(cm.exception))
+            self.assertEqual(callback.numcols, 2)
+            self.assertEqual(len(lp.rows), 1)
+        self.assertIsNone(lp.integer())
+
+
+class CancelTokenTest(unittest.TestCase):
+    """Stop solves through a CancelToken."""
+    def setUp(self):
+        self.lp = build_lp(obj=(2, 1))
+
+    def testToken(self):
+        """Tests cancelling a token, directly or through its timeout."""
+        token = CancelToken()
+        self.assertFalse(token.cancelled)
+        token.cancel()
+        self.assertTrue(token.cancelled)
+        self.assertTrue(CancelToken(timeout=0).cancelled)
+        self.assertFalse(CancelToken(timeout=3600).cancelled)
+        self.assertRaises(ValueError, CancelToken, timeout=-1)
+        self.assertRaises(TypeError, CancelToken, timeout='1')
+        self.assertRaises(TypeError, self.lp.simplex, cancel=1)
+
+    def testUncancelled(self):
+        """Tests that a live token leaves the solvers' results alone."""
+        token = CancelToken()
+        for solve in (self.lp.simplex, self.lp.exact, self.lp.interior):
+            self.assertIsNone(solve(cancel=token))
+            self.assertAlmostEqual(self.lp.cols[0].value, 1.0)
+            self.assertAlmostEqual(self.lp.cols[1].value, 0.5)
+        self.assertIsNone(self.lp.simplex(cancel=None, nogil=True))
+        self.assertEqual(self.lp.simplex(cancel=token, it_lim=0), 'itlim')
+        for c in self.lp.cols:
+            c.kind = int
+        self.lp.simplex()
+        self.assertIsNone(self.lp.integer(cancel=token))
+        self.assertAlmostEqual(self.lp.obj.value, 2.0)
+
+    def testCancelled(self):
+        """Tests that each solver method stops upon a cancelled token."""
+        token = CancelToken()
+        token.cancel()
+        self.assertEqual(self.lp.simplex(cancel=token), 'cancelled')
+        self.assertEqual(self.lp.exact(cancel=token), 'cancelled')
+        self.assertEqual(self.lp.interior(cancel=token), 'cancelled')
+        self.assertEqual(self.lp.status, 'undef')
+        self.assertEqual(solve_many([self.lp], cancel=token), ['cancelled'])
+        self.assertEqual(self.lp.solve_concurrent(['primal'], cancel=token),
+                         ('cancelled', 'primal'))
+        async def solve():
+            return await self.lp.simplex_async(cancel=token)
+        self.assertEqual(asyncio.run(solve()), 'cancelled')
+        for c in self.lp.cols:
+            c.kind = int
+        self.lp.simplex()
+        self.assertEqual(self.lp.integer(cancel=token), 'cancelled')
+        self.assertEqual(self.lp.integer_race([{}], cancel=token),
+                         ('cancelled', 0))
+
+    def testCancelFromCallback(self):
+        """Tests cancelling an integer solve from its own callback."""
+        token = CancelToken()
+        class Callback:
+            def default(self, tree):
+                token.cancel()
+        for c in self.lp.cols:
+            c.kind = int
+        self.lp.simplex()
+        self.assertEqual(self.lp.integer(callback=Callback(), cancel=token),
+                         'cancelled')
+
+
+CALLBACK = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p)
+
+
+def make_capsule(func, context=None, name=b'void (glp_tree *, void *)'):
+    """Wraps a ctypes function pointer, and its context, in a PyCapsule."""
+    new = ctypes.pythonapi.PyCapsule_New
+    new.restype = ctypes.py_object
+    new.argtypes = (ctypes.c_void_p, ctypes.c_char_p, ctypes.c_void_p)
+    capsule = new(ctypes.cast(func, ctypes.c_void_p), name, None)
+    if context is not None:
+        set_context = ctypes.pythonapi.PyCapsule_SetContext
+        set_context.argtypes = (ctypes.py_object, ctypes.c_void_p)
+        set_context(capsule, context)
+    return capsule
+
+
+class NativeCallbackTest(unittest.TestCase):
+    """Run C functions in a PyCapsule as callbacks of the integer solver."""
+    def setUp(self):
+        self.lp = build_lp(kind=int, obj=(2, 1))
+        self.lp.simplex()
+        self.calls = ctypes.c_int(0)
+
+        def count(tree, info):
+            ctypes.cast(info, ctypes.POINTER(ctypes.c_int))[0] += 1
+        self.func = CALLBACK(count)
+        self.capsule = make_capsule(self.func, ctypes.addressof(self.calls))
+
+    def testInteger(self):
+        """Tests that integer() calls the C function with its context."""
+        self.assertIsNone(self.lp.integer(callback=self.capsule))
+        self.assertGreater(self.calls.value, 0)
+        self.assertAlmostEqual(self.lp.obj.value, 2.0)
+        calls = self.calls.value
+        self.assertIsNone(self.lp.integer(callback=self.capsule, nogil=True,
+                                          cancel=CancelToken()))
+        self.assertGreater(self.calls.value, calls)
+
+    def testThreaded(self):
+        """Tests C callbacks in the solvers running on other threads."""
+        self.assertEqual(solve_many([self.lp], method='integer',
+                                    callback=self.capsule), [None])
+        self.assertGreater(self.calls.value, 0)
+        self.assertEqual(self.lp.integer_race([{'callback': self.capsule}]),
+                         (None, 0))
+        async def solve():
+            return await self.lp.integer_async(callback=self.capsule)
+        self.assertIsNone(asyncio.run(solve()))
+        self.assertAlmostEqual(self.lp.obj.value, 2.0)
+        self.assertRaises(ValueError, solve_many, [self.lp],
+                          method='integer', callback=object())
+
+    def testBadCapsule(self):
+        """Tests that unnamed capsules and those of other names are
+        rejected."""
+        for name in (b'int (void)', None):
+            capsule = make_capsule(self.func, name=name)
+            self.assertRaises(ValueError, self.lp.integer, callback=capsule)
+        self.assertEqual(self.calls.value, 0)
+
+
+class TreeCutTest(unittest.TestCase):
+    """Use the Tree's bulk methods from the integer solver's callbacks.
+
+    max (x+y) subject to
+    2*x + 2*y <= 3
+    x, y binary
+
+    The relaxation has value 1.5, but the cut x + y <= 1 makes it integral,
+    with value 1."""
+    def setUp(self):
+        lp = self.lp = LPX()
+        lp.rows.add(1)
+        lp.cols.add(2)
+        for c in lp.cols:
+            c.bounds = 0, 1
+            c.kind = int
+        lp.obj[:] = [1, 1]
+        lp.obj.maximize = True
+        lp.rows[0].matrix = [2.0, 2.0]
+        lp.rows[0].bounds = None, 3
+        lp.simplex()
+        self.cut = (array('i', [0, 2]), array('i', [0, 1]),
+                    array('d', [1.0, 1.0]), array('d', [1.0]))
+
+    def testAddCuts(self):
+        """Tests adding cuts to the pool, and deleting them."""
+        testobj = self
+        sizes = []
+
+        class Callback:
+            def cutgen(self, tree):
+                tree.add_cuts(*testobj.cut)
+                tree.add_cuts(array('i', [0, 1, 2]), array('i', [0, 1]),
+                              array('d', [1.0, 1.0]), array('d', [0, 0]),
+                              '>=')
+                sizes.append(tree.pool_size)
+                tree.del_cuts(array('i', [1, 2, 2]))
+                sizes.append(tree.pool_size)
+
+            def default(self, tree):
+                testobj.assertRaises(RuntimeError, getattr, tree,
+                                     'pool_size')
+                testobj.assertRaises(RuntimeError, tree.add_cuts,
+                                     *testobj.cut)
+
+        self.assertIsNone(self.lp.integer(callback=Callback()))
+        self.assertEqual(sizes[:2], [3, 1])
+        self.assertAlmostEqual(self.lp.obj.value, 1.0)
+        self.assertEqual(len(self.lp.rows), 1)
+
+    def testBadCuts(self):
+        """Tests that malformed cuts are rejected before reaching GLPK."""
+        testobj = self
+        errors = []
+        ptr, ind, val, rhs = self.cut
+
+        class Callback:
+            def cutgen(self, tree):
+                for args, error in [
+                        ((ptr, array('i', [0, 2]), val, rhs), IndexError),
+                        ((ptr, array('i', [1, 1]), val, rhs), ValueError),
+                        ((array('i', [0, 1]), ind, val, rhs), ValueError),
+                        ((ptr, ind, array('d', [1.0]), rhs), ValueError),
+                        ((ptr, ind, val, rhs, '=='), ValueError),
+                        ((ptr, ind, val, [1.0]), TypeError)]:
+                    testobj.assertRaises(error, tree.add_cuts, *args)
+                    errors.append(error)
+                testobj.assertRaises(IndexError, tree.del_cuts,
+                                     array('i', [0]))
+                tree.add_cuts(ptr, ind, val, rhs)
+                tree.del_cuts()
+                testobj.assertEqual(tree.pool_size, 0)
+
+        self.assertIsNone(self.lp.integer(callback=Callback()))
+        self.assertTrue(errors)
+
+    def testNodeArrays(self):
+        """Tests reading the node's relaxation solution as arrays."""
+        testobj = self
+        seen = []
+
+        class Callback:
+            def heur(self, tree):
+                cols, rows = tree.lp.cols, tree.lp.rows
+                primal = tree.node_primal()
+                testobj.assertEqual(primal.format, 'd')
+                testobj.assertEqual(list(primal), [c.primal for c in cols])
+                testobj.assertEqual(list(tree.node_primal(rows=True)),
+                                    [r.primal for r in rows])
+                testobj.assertEqual(list(tree.node_dual()),
+                                    [c.dual for c in cols])
+                testobj.assertEqual(list(tree.node_dual(True)),
+                                    [r.dual for r in rows])
+                basis = tree.lp.get_basis()
+                testobj.assertEqual(list(tree.node_status(rows=True)),
+                                    list(basis[0]))
+                testobj.assertEqual(list(tree.node_status()), list(basis[1]))
+                seen.append(sum(primal))
+                self.tree = tree
+
+        callback = Callback()
+        self.assertIsNone(self.lp.integer(callback=callback))
+        self.assertAlmostEqual(seen[0], 1.5)
+        self.assertRaises(RuntimeError, callback.tree.node_primal)
+
+    def testHeuristicBuffers(self):
+        """Tests offering heuristic solutions as buffers."""
+        testobj = self
+        results = []
+
+        class Callback:
+            def heur(self, tree):
+                testobj.assertRaises(ValueError, tree.heuristic,
+                                     array('d', [1.0]))
+                testobj.assertRaises(ValueError, tree.heuristics,
+                                     array('d', [1.0, 0.0, 1.0]))
+                testobj.assertRaises(TypeError, tree.heuristics, [1.0, 0.0])
+                # Each point must improve upon those accepted before it.
+                points = memoryview(array('d', [0, 0, 1, 0, 0, 1, 0, 0]))
+                results.append(tree.heuristics(points.cast('B').cast(
+                    'd', (4, 2))))
+                results.append(tree.heuristic(array('i', [0, 1])))
+                results.append(tree.heuristics(array('d')))
+
+            def default(self, tree):
+                testobj.assertRaises(RuntimeError, tree.heuristics,
+                                     array('d', [1.0, 0.0]))
+
+        self.assertIsNone(self.lp.integer(callback=Callback()))
+        self.assertEqual(results[:3], [[True, True, False, False], False,
+                                       []])
+        self.assertAlmostEqual(self.lp.obj.value, 1.0)
+
+    def testLazyConstraints(self):
+        """Tests adding lazy constraints as rows from rowgen."""
+        testobj = self
+
+        class Callback:
+            def __init__(self):
+                self.added = 0
+
+            def rowgen(self, tree):
+                if len(tree.lp.rows) == 1:
+                    tree.add_cuts(*testobj.cut)
+                    self.added += 1
+                else:
+                    testobj.assertEqual(tree.lp.rows[1].bounds, (None, 1.0))
+
+        callback = Callback()
+        self.assertIsNone(self.lp.integer(callback=callback))
+        self.assertTrue(callback.added)
+        self.assertAlmostEqual(self.lp.obj.value, 1.0)
+        # The solver drops the rows it added once done.
+        self.assertEqual(len(self.lp.rows), 1)
+
+
+class NativeSearchTest(unittest.TestCase):
+    """Select nodes and branch with the native sel_tech and sb_tech.
+
+    A knapsack problem with 10 items, whose optimal value is 309."""
+    def setUp(self):
+        weights = [23, 31, 29, 44, 53, 38, 63, 85, 89, 82]
+        values = [92, 57, 49, 68, 60, 43, 67, 84, 87, 72]
+        lp = self.lp = LPX()
+        lp.rows.add(1)
+        lp.cols.add(len(weights))
+        for c in lp.cols:
+            c.kind = bool
+        lp.obj[:] = values
+        lp.obj.maximize = True
+        lp.rows[0].matrix = weights
+        lp.rows[0].bounds = None, 165
+        self.techs = LPX.SEL_BEP, LPX.SEL_DFP, LPX.SEL_HYB
+
+    def testTechniques(self):
+        """Tests each technique finds the optimum."""
+        for tech in self.techs:
+            self.lp.std_basis()
+            self.lp.simplex()
+            self.assertIsNone(self.lp.integer(
+                sel_tech=tech, sel_frq=2, sel_gap=0.01, pp_tech=LPX.PP_NONE))
+            self.assertAlmostEqual(self.lp.obj.value, 309)
+
+    def testStrongBranching(self):
+        """Tests strong and reliability branching find the optimum."""
+        for tech in LPX.SB_OFF, LPX.SB_FULL, LPX.SB_REL:
+            self.lp.simplex()
+            self.assertIsNone(self.lp.integer(
+                sb_tech=tech, sb_it_lim=5, sel_tech=LPX.SEL_DFP,
+                pp_tech=LPX.PP_NONE))
+            self.assertAlmostEqual(self.lp.obj.value, 309)
+        for tech in self.techs:
+            self.lp.simplex()
+            self.assertIsNone(self.lp.integer(sb_tech=LPX.SB_REL,
+                                              sel_tech=tech))
+            self.assertAlmostEqual(self.lp.obj.value, 309)
+
+    def testCallbackActsFirst(self):
+        """Tests the technique leaves what the callback did alone."""
+        testobj = self
+
+        class Callback:
+            def __init__(self):
+                self.selects = self.branches = 0
+
+            def select(self, tree):
+                if self.selects % 2:
+                    tree.select(tree.best_node)
+                self.selects += 1
+
+            def branch(self, tree):
+                if self.branches % 2:
+                    col = [c.index + 1 for c in tree.lp.cols
+                           if tree.can_branch(c.index + 1)][0]
+                    tree.branch_upon(col)
+                    testobj.assertRaises(RuntimeError, tree.branch_upon,
+                                         col)
+                self.branches += 1
+
+        for tech in self.techs:
+            callback = Callback()
+            self.lp.simplex()
+            self.assertIsNone(self.lp.integer(sel_tech=tech,
+                                              callback=callback,
+                                              pp_tech=LPX.PP_NONE))
+            self.assertAlmostEqual(self.lp.obj.value, 309)
+            self.assertTrue(callback.branches)
+
+    def testSolveMany(self):
+        """Tests the techniques on the solving threads."""
+        self.lp.simplex()
+        for tech in self.techs:
+            self.assertEqual(solve_many([self.lp], 'integer', sel_tech=tech),
+                             [None])
+            self.assertAlmostEqual(self.lp.obj.value, 309)
+        self.assertEqual(solve_many([self.lp], 'integer',
+                                    sb_tech=LPX.SB_REL), [None])
+        self.assertAlmostEqual(self.lp.obj.value, 309)
@@ -2,6 +2,7 @@
 
 
 from glpk import LPX, env
+import array
 import unittest
 
 
@@ -417,6 +418,83 @@ class ScaleVectorTestCase:
             del self.vc[0].scale
 
 
+class BulkVectorTestCase:
+    """Tests setting attributes of all vectors at once from buffers."""
+    def moreSetUp(self):
+        self.num_vecs = 5
+        self.vc.add(self.num_vecs)
+
+    def testSetBounds(self):
+        """Tests setting all bounds at once."""
+        inf, nan = float('inf'), float('nan')
+        lb = array.array('d', [2, -inf, nan, 3.3, -1])
+        ub = array.array('d', [4, 7, inf, 3.3, nan])
+        self.vc.set_bounds(lb, ub)
+        self.assertEqual([v.bounds for v in self.vc],
+                         [(2, 4), (None, 7), (None, None), (3.3, 3.3),
+                          (-1, None)])
+        lb, ub = self.vc.get_bounds()
+        self.assertEqual(lb.format, 'd')
+        self.assertEqual(list(lb), [2, -inf, -inf, 3.3, -1])
+        self.assertEqual(list(ub), [4, 7, inf, 3.3, inf])
+        self.vc.set_bounds(array.array('i', range(5)), ub)
+        self.assertEqual([v.bounds for v in self.vc],
+                         [(0, 4), (1, 7), (2, None), (3, 3.3), (4, None)])
+
+    def testSetBadBounds(self):
+        """Tests that bad bulk bounds are caught and change nothing."""
+        self.vc[0].bounds = 3, 5
+        lb = array.array('d', [6, 0, 0, 0, 0])
+        ub = array.array('d', [4, 1, 1, 1, 1])
+        with self.assertRaises(ValueError):
+            self.vc.set_bounds(lb, ub)
+        with self.assertRaises(ValueError):
+            self.vc.set_bounds(lb[1:], ub[1:])
+        with self.assertRaises(TypeError):
+            self.vc.set_bounds([0] * 5, ub)
+        self.assertEqual(self.vc[0].bounds, (3, 5))
+        self.assertEqual(self.vc[1].bounds, self.vc[4].bounds)
+
+    def testSetScale(self):
+        """Tests setting all scale factors at once."""
+        self.vc.set_scale(array.array('d', [1, 2, 3.14159, 4, 5]))
+        self.assertAlmostEqual(self.vc[2].scale, 3.14159)
+        self.assertAlmostEqual(self.vc[4].scale, 5)
+        with self.assertRaises(ValueError):
+            self.vc.set_scale(array.array('d', [1, 2, 0, 4, 5]))
+        self.assertAlmostEqual(self.vc[2].scale, 3.14159)
+
+    def testSetNames(self):
+        """Tests setting all names at once."""
+        self.vc.set_names(['a', 'b', None, 'd', 'e'])
+        self.assertEqual([v.name for v in self.vc],
+                         ['a', 'b', None, 'd', 'e'])
+        self.assertEqual(self.vc['d'].index, 3)
+        with self.assertRaises(ValueError):
+            self.vc.set_names(['a', 'b'])
+        with self.assertRaises(ValueError):
+            self.vc.set_names(['a', 'b', 'c', 'd', 'e' * 256])
+        with self.assertRaises(TypeError):
+            self.vc.set_names(['a', 'b', 'c', 'd', 5])
+        self.assertEqual(self.vc[2].name, None)
+
+    def testSetKinds(self):
+        """Tests setting all kinds at once."""
+        codes = array.array('b', [LPX.CV, LPX.IV, LPX.BV, LPX.CV, LPX.IV])
+        if self.vc[0].isrow:
+            with self.assertRaises(ValueError):
+                self.vc.set_kinds(codes)
+            self.vc.set_kinds(array.array('b', [LPX.CV] * 5))
+        else:
+            self.vc.set_kinds(codes)
+            self.assertEqual([v.kind for v in self.vc],
+                             [float, int, bool, float, int])
+        with self.assertRaises(ValueError):
+            self.vc.set_kinds(array.array('i', [0, 1, 1, 1, 1]))
+        with self.assertRaises(TypeError):
+            self.vc.set_kinds(array.array('d', [1, 1, 1, 1, 1]))
+
+
 class RowTestCase(unittest.TestCase):
     def moreSetUp(self): pass
 
@@ -475,6 +553,14 @@ class ScaleColumnTestCase(ScaleVectorTestCase, ColumnTestCase):
     pass
 
 
+class BulkRowTestCase(BulkVectorTestCase, RowTestCase):
+    pass
+
+
+class BulkColumnTestCase(BulkVectorTestCase, ColumnTestCase):
+    pass
+
+
 class ComparisonTestCase(unittest.TestCase):
     """Test the rich comparison operators on vectors."""
     def setUp(self):